@@ -0,0 +1,137 @@
+import argparse
+import csv
+import math
+import os
+import re
+import subprocess
+
+from generate_instances import generate_corpus
+
+# The bipartite engine is not part of the model, the solver only runs it with bipartiteContraction or --engine
+ENGINES = ["degree", "walk"]
+FEATURES = ["vertices", "edges", "mean_degree", "max_degree", "deviation", "bipartite", "twins", "clustering"]
+# Model inputs in the order of ComponentFeatures::values() in src/HeuristicSelection.hpp
+COEFFICIENTS = ["intercept", "log_vertices", "log_edges", "mean_degree", "log_max_degree", "deviation", "bipartite", "twins",
+                "clustering"]
+
+FEATURES_LINE = re.compile(r"c Features: n (\d+), m (\d+), mean degree ([\d.e+-]+), max degree (\d+), "
+                           r"deviation ([\d.e+-]+), bipartite (\d), twins ([\d.e+-]+), clustering ([\d.e+-]+)")
+ENGINE_LINE = re.compile(r"c Engine (\w+): width (\d+) in ([\d.e+-]+) s")
+
+
+# Run the solver with a forced engine, returns one measurement per component that reached the engine
+def measure(solver_path, test_file, engine, timeout_seconds, min_vertices):
+    try:
+        with open(test_file) as stdin:
+            output = subprocess.run([solver_path, "--engine", engine], stdin=stdin, capture_output=True, text=True,
+                                    timeout=timeout_seconds).stdout
+    except subprocess.TimeoutExpired:
+        print(f"WARNING: {os.path.basename(test_file)} timed out with engine {engine}")
+        return []
+
+    rows = []
+    features = None
+    for line in output.splitlines():
+        match = FEATURES_LINE.match(line)
+        if match:
+            features = dict(zip(FEATURES, match.groups()))
+            continue
+        match = ENGINE_LINE.match(line)
+        if match and features is not None and match.group(1) == engine and int(features["vertices"]) >= min_vertices:
+            rows.append({"Test": os.path.basename(test_file), "Engine": engine, **features,
+                         "Width": match.group(2), "Seconds": match.group(3)})
+            features = None
+    return rows
+
+
+def model_inputs(row):
+    return [1.0, math.log(float(row["vertices"]) + 1), math.log(float(row["edges"]) + 1), float(row["mean_degree"]),
+            math.log(float(row["max_degree"]) + 1), float(row["deviation"]), float(row["bipartite"]), float(row["twins"]),
+            float(row["clustering"])]
+
+
+# Ridge regression by the normal equations, the intercept is not penalised
+def fit(inputs, targets, ridge):
+    size = len(inputs[0])
+    matrix = [[sum(x[i] * x[j] for x in inputs) + (ridge if i == j and i > 0 else 0.0) for j in range(size)]
+              for i in range(size)]
+    vector = [sum(x[i] * y for x, y in zip(inputs, targets)) for i in range(size)]
+
+    # Gaussian elimination with partial pivoting
+    for column in range(size):
+        pivot = max(range(column, size), key=lambda r: abs(matrix[r][column]))
+        matrix[column], matrix[pivot] = matrix[pivot], matrix[column]
+        vector[column], vector[pivot] = vector[pivot], vector[column]
+        for r in range(column + 1, size):
+            factor = matrix[r][column] / matrix[column][column]
+            for c in range(column, size):
+                matrix[r][c] -= factor * matrix[column][c]
+            vector[r] -= factor * vector[column]
+    solution = [0.0] * size
+    for r in reversed(range(size)):
+        solution[r] = (vector[r] - sum(matrix[r][c] * solution[c] for c in range(r + 1, size))) / matrix[r][r]
+    return solution
+
+
+def mean_error(coefficients, inputs, targets):
+    return sum(abs(sum(c * x for c, x in zip(coefficients, row)) - y) for row, y in zip(inputs, targets)) / len(targets)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Fit the runtime and width model used to choose a heuristic per component")
+    parser.add_argument("solver_path", type=str, nargs="?", help="Path to the solver executable (not needed with --from-csv)")
+    parser.add_argument("--corpus", type=str, default="calibration.csv", help="Corpus CSV (columns: Test,Family,Params,Seed)")
+    parser.add_argument("--tests", type=str, default="../tests/calibration", help="Folder for the generated instances")
+    parser.add_argument("--instances", type=str, nargs="*", default=[], help="Further .gr files to measure, e.g. benchmark instances")
+    parser.add_argument("--timeout", type=int, default=600, help="Time limit per solver run in seconds")
+    parser.add_argument("--min-vertices", type=int, default=20, help="Ignore smaller components (timer noise)")
+    parser.add_argument("--measurements", type=str, default="baselines/cost_measurements.csv", help="Measurements CSV written by this run")
+    parser.add_argument("--from-csv", type=str, nargs="*", default=None, help="Fit from existing measurement CSVs instead of running the solver")
+    parser.add_argument("--ridge", type=float, default=1.0, help="Ridge penalty of the fit")
+    parser.add_argument("--output", type=str, default="baselines/cost_model.csv", help="Model CSV, read by the solver with --cost-model")
+    args = parser.parse_args()
+
+    rows = []
+    if args.from_csv is not None:
+        for path in args.from_csv:
+            with open(path) as file:
+                rows += list(csv.DictReader(file))
+    else:
+        if args.solver_path is None:
+            parser.error("solver_path is required unless --from-csv is given")
+        tests = generate_corpus(args.corpus, args.tests) + args.instances
+        for test_file in tests:
+            for engine in ENGINES:
+                measured = measure(args.solver_path, test_file, engine, args.timeout, args.min_vertices)
+                for row in measured:
+                    print(f"{row['Test']:<30} {engine:<10} n={row['vertices']:<8} {row['Seconds']:>10} s  width {row['Width']}")
+                rows += measured
+        os.makedirs(os.path.dirname(args.measurements) or ".", exist_ok=True)
+        with open(args.measurements, "w", newline="") as file:
+            writer = csv.DictWriter(file, fieldnames=["Test", "Engine"] + FEATURES + ["Width", "Seconds"])
+            writer.writeheader()
+            writer.writerows(rows)
+        print(f"Measurements written to {args.measurements}")
+
+    model = []
+    for engine in ENGINES:
+        engine_rows = [row for row in rows if row["Engine"] == engine]
+        if len(engine_rows) < len(COEFFICIENTS):
+            print(f"WARNING: only {len(engine_rows)} measurements for {engine}, the solver keeps its built-in coefficients")
+            continue
+        inputs = [model_inputs(row) for row in engine_rows]
+        log_seconds = [math.log(max(float(row["Seconds"]), 1e-4)) for row in engine_rows]
+        widths = [float(row["Width"]) for row in engine_rows]
+        seconds_model = fit(inputs, log_seconds, args.ridge)
+        width_model = fit(inputs, widths, args.ridge)
+        print(f"{engine}: {len(engine_rows)} components, mean error {mean_error(seconds_model, inputs, log_seconds):.2f} "
+              f"in ln(seconds), {mean_error(width_model, inputs, widths):.2f} in width")
+        model.append([engine, "log_seconds"] + [f"{c:.4g}" for c in seconds_model])
+        model.append([engine, "width"] + [f"{c:.4g}" for c in width_model])
+
+    os.makedirs(os.path.dirname(args.output) or ".", exist_ok=True)
+    with open(args.output, "w", newline="") as file:
+        writer = csv.writer(file)
+        writer.writerow(["Engine", "Target"] + COEFFICIENTS)
+        writer.writerows(model)
+    print(f"Model written to {args.output}")
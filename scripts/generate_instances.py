@@ -0,0 +1,241 @@
+import argparse
+import csv
+import os
+import random
+
+
+# Erdős–Rényi G(n, p) graph
+def erdos_renyi(rng, n, p):
+    edges = set()
+    for u in range(n):
+        for v in range(u + 1, n):
+            if rng.random() < p:
+                edges.add((u, v))
+    return n, edges
+
+
+# rows x cols grid graph
+def grid(rng, rows, cols):
+    edges = set()
+    for r in range(rows):
+        for c in range(cols):
+            v = r * cols + c
+            if c + 1 < cols:
+                edges.add((v, v + 1))
+            if r + 1 < rows:
+                edges.add((v, v + cols))
+    return rows * cols, edges
+
+
+# Random cograph built by recursive disjoint unions and joins (twin-width 0)
+def cograph(rng, n):
+    def build(vertices):
+        if len(vertices) == 1:
+            return set()
+        split = rng.randint(1, len(vertices) - 1)
+        left, right = vertices[:split], vertices[split:]
+        edges = build(left) | build(right)
+        if rng.random() < 0.5:
+            edges |= {(min(u, v), max(u, v)) for u in left for v in right}
+        return edges
+
+    vertices = list(range(n))
+    rng.shuffle(vertices)
+    return n, build(vertices)
+
+
+# Paley graph on q vertices, q prime with q = 1 mod 4 (twin-width (q - 1) / 2)
+def paley(rng, q):
+    if q % 4 != 1 or any(q % d == 0 for d in range(2, int(q ** 0.5) + 1)):
+        raise ValueError("Paley graphs need a prime q with q = 1 mod 4, got " + str(q))
+    squares = {(x * x) % q for x in range(1, q)}
+    edges = set()
+    for u in range(q):
+        for v in range(u + 1, q):
+            if (v - u) % q in squares:
+                edges.add((u, v))
+    return q, edges
+
+
+# Uniform random labelled tree from a Prüfer sequence (twin-width at most 2)
+def tree(rng, n):
+    if n < 2:
+        return n, set()
+    pruefer = [rng.randrange(n) for _ in range(n - 2)]
+    degree = [1] * n
+    for v in pruefer:
+        degree[v] += 1
+    edges = set()
+    for v in pruefer:
+        leaf = min(u for u in range(n) if degree[u] == 1)
+        edges.add((min(leaf, v), max(leaf, v)))
+        degree[leaf] -= 1
+        degree[v] -= 1
+    u, v = [u for u in range(n) if degree[u] == 1]
+    edges.add((u, v))
+    return n, edges
+
+
+# G(base, p) where every vertex is blown up into a class of true or false twins
+def planted_twins(rng, base, p, class_size):
+    _, base_edges = erdos_renyi(rng, base, p)
+    classes = []
+    n = 0
+    for _ in range(base):
+        size = rng.randint(1, class_size)
+        classes.append(list(range(n, n + size)))
+        n += size
+
+    edges = set()
+    for u, v in base_edges:
+        for x in classes[u]:
+            for y in classes[v]:
+                edges.add((min(x, y), max(x, y)))
+    for members in classes:
+        if rng.random() < 0.5:
+            edges |= {(x, y) for x in members for y in members if x < y}
+
+    # Shuffle labels so that twins are not consecutive in the input
+    labels = list(range(n))
+    rng.shuffle(labels)
+    return n, {(min(labels[u], labels[v]), max(labels[u], labels[v])) for u, v in edges}
+
+
+# Random bipartite graph with sides of n1 and n2 vertices, every cross pair is an edge with probability p
+def random_bipartite(rng, n1, n2, p):
+    edges = set()
+    for u in range(n1):
+        for v in range(n2):
+            if rng.random() < p:
+                edges.add((u, n1 + v))
+    return n1 + n2, edges
+
+
+# Random geometric graph: n points in the unit square, joined if closer than radius
+def geometric(rng, n, radius):
+    points = [(rng.random(), rng.random()) for _ in range(n)]
+    cells = {}
+    for v, (x, y) in enumerate(points):
+        cells.setdefault((int(x / radius), int(y / radius)), []).append(v)
+    edges = set()
+    for (cx, cy), members in cells.items():
+        for dx in (-1, 0, 1):
+            for dy in (-1, 0, 1):
+                for u in members:
+                    for v in cells.get((cx + dx, cy + dy), []):
+                        if u < v and (points[u][0] - points[v][0]) ** 2 + (points[u][1] - points[v][1]) ** 2 < radius ** 2:
+                            edges.add((u, v))
+    return n, edges
+
+
+# Barabási–Albert preferential attachment, every new vertex gets m edges (heavy-tailed degrees)
+def powerlaw(rng, n, m):
+    edges = set()
+    targets = []
+    for v in range(m + 1):
+        for u in range(v):
+            edges.add((u, v))
+            targets += [u, v]
+    for v in range(m + 1, n):
+        chosen = set()
+        while len(chosen) < m:
+            chosen.add(rng.choice(targets))
+        for u in chosen:
+            edges.add((u, v))
+            targets += [u, v]
+    return n, edges
+
+
+# k disjoint stars with the given number of leaves each (twin-width 0)
+def stars(rng, k, leaves):
+    edges = set()
+    for s in range(k):
+        center = s * (leaves + 1)
+        edges |= {(center, center + i) for i in range(1, leaves + 1)}
+    return shuffled(rng, k * (leaves + 1), edges)
+
+
+# Path of spine vertices with up to the given number of leaves at every spine vertex (twin-width at most 1)
+def caterpillar(rng, spine, leaves):
+    edges = {(v, v + 1) for v in range(spine - 1)}
+    n = spine
+    for v in range(spine):
+        for _ in range(rng.randint(0, leaves)):
+            edges.add((v, n))
+            n += 1
+    return shuffled(rng, n, edges)
+
+
+# Random relabelling, so that the structure does not follow the vertex order
+def shuffled(rng, n, edges):
+    labels = list(range(n))
+    rng.shuffle(labels)
+    return n, {(min(labels[u], labels[v]), max(labels[u], labels[v])) for u, v in edges}
+
+
+FAMILIES = {
+    "er": (erdos_renyi, [int, float]),
+    "grid": (grid, [int, int]),
+    "cograph": (cograph, [int]),
+    "paley": (paley, [int]),
+    "tree": (tree, [int]),
+    "twins": (planted_twins, [int, float, int]),
+    "bipartite": (random_bipartite, [int, int, float]),
+    "geometric": (geometric, [int, float]),
+    "powerlaw": (powerlaw, [int, int]),
+    "stars": (stars, [int, int]),
+    "caterpillar": (caterpillar, [int, int]),
+}
+
+
+def generate(family, params, seed):
+    builder, types = FAMILIES[family]
+    if len(params) != len(types):
+        raise ValueError(family + " expects " + str(len(types)) + " parameters, got " + str(len(params)))
+    rng = random.Random(seed)
+    return builder(rng, *[t(p) for t, p in zip(types, params)])
+
+
+# Write the graph in PACE format, comments go after the p-line so that benchmark.sh can still read n and m from it
+def write_graph(path, n, edges, comment=""):
+    with open(path, "w") as file:
+        file.write(f"p tww {n} {len(edges)}\n")
+        if comment:
+            file.write(f"c {comment}\n")
+        for u, v in sorted(edges):
+            file.write(f"{u + 1} {v + 1}\n")
+
+
+# Generate every instance listed in a corpus file (columns: Test,Family,Params,Seed)
+def generate_corpus(corpus_file, out_dir):
+    os.makedirs(out_dir, exist_ok=True)
+    paths = []
+    with open(corpus_file) as file:
+        for row in csv.DictReader(file):
+            params = row["Params"].split()
+            n, edges = generate(row["Family"], params, int(row["Seed"]))
+            path = os.path.join(out_dir, row["Test"])
+            write_graph(path, n, edges, f"family={row['Family']} params={row['Params']} seed={row['Seed']}")
+            paths.append(path)
+    return paths
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Generate seeded synthetic twin-width instances")
+    parser.add_argument("family", type=str, nargs="?", choices=sorted(FAMILIES), help="Graph family")
+    parser.add_argument("params", type=str, nargs="*", help="Family parameters, e.g. 'er 500 0.05' or 'grid 20 30'")
+    parser.add_argument("--seed", type=int, default=12345, help="Random seed")
+    parser.add_argument("-o", "--output", type=str, default=None, help="Output .gr file (default: stdout)")
+    parser.add_argument("--corpus", type=str, default=None, help="Generate all instances of a corpus CSV instead")
+    parser.add_argument("--out-dir", type=str, default="../tests/synthetic", help="Output folder for --corpus")
+    args = parser.parse_args()
+
+    if args.corpus:
+        for path in generate_corpus(args.corpus, args.out_dir):
+            print(path)
+    elif args.family:
+        n, edges = generate(args.family, args.params, args.seed)
+        comment = f"family={args.family} params={' '.join(args.params)} seed={args.seed}"
+        write_graph(args.output if args.output else "/dev/stdout", n, edges, comment)
+    else:
+        parser.error("either a family or --corpus is required")
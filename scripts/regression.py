@@ -0,0 +1,113 @@
+import argparse
+import csv
+import os
+import subprocess
+import sys
+import time
+
+from generate_instances import generate_corpus
+from verifier import read_graph, read_sequence, check_sequence
+
+
+# Run the solver with the given options on one instance and return (elapsed seconds, verified width or None)
+def run_instance(solver_path, test_file, timeout_seconds, options=()):
+    start = time.perf_counter()
+    try:
+        with open(test_file) as stdin:
+            output = subprocess.run([solver_path, *options], stdin=stdin, capture_output=True, text=True,
+                                    timeout=timeout_seconds).stdout
+    except subprocess.TimeoutExpired:
+        return timeout_seconds, None
+    elapsed = time.perf_counter() - start
+
+    solution_file = test_file + ".sol"
+    with open(solution_file, "w") as file:
+        file.write(output)
+    try:
+        width = check_sequence(read_graph(test_file), read_sequence(solution_file))
+    except Exception as e:
+        print(f"WARNING: {os.path.basename(test_file)} produced an invalid sequence: {e}")
+        width = None
+    os.remove(solution_file)
+    return elapsed, width
+
+
+def read_baseline(baseline_file):
+    if not os.path.exists(baseline_file):
+        return {}
+    with open(baseline_file) as file:
+        return {row["Test"]: row for row in csv.DictReader(file)}
+
+
+def is_slow(elapsed, baseline, slowdown, min_time):
+    # Relative to the baseline, the absolute floor only filters timer noise on instances that take milliseconds
+    baseline_time = float(baseline["Time"])
+    return elapsed > baseline_time * slowdown and elapsed - baseline_time > min_time
+
+
+# Compare one result against its baseline row, returns a list of human readable regressions
+def compare(test_name, elapsed, width, baseline, slowdown, min_time):
+    if baseline is None:
+        return []
+    regressions = []
+    if width is None:
+        regressions.append(f"{test_name}: no valid solution (baseline width {baseline['Solution']})")
+    elif baseline["Solution"] and width > int(baseline["Solution"]):
+        regressions.append(f"{test_name}: width {width} > baseline {baseline['Solution']}")
+    if is_slow(elapsed, baseline, slowdown, min_time):
+        baseline_time = float(baseline["Time"])
+        regressions.append(f"{test_name}: time {elapsed:.3f}s > {slowdown}x baseline {baseline_time:.3f}s")
+    return regressions
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Run the solver on the synthetic corpus and compare against baselines")
+    parser.add_argument("solver_path", type=str, help="Path to the solver executable")
+    parser.add_argument("--corpus", type=str, default="corpus.csv", help="Corpus CSV (columns: Test,Family,Params,Seed)")
+    parser.add_argument("--baseline", type=str, default="baselines/corpus.csv", help="Baseline results CSV")
+    parser.add_argument("--tests", type=str, default="../tests/synthetic", help="Folder for the generated instances")
+    parser.add_argument("--timeout", type=int, default=300, help="Time limit per instance in seconds")
+    parser.add_argument("--slowdown", type=float, default=1.5, help="Flag instances slower than this factor of the baseline")
+    parser.add_argument("--min-time", type=float, default=0.05, help="Ignore slowdowns of less than this many seconds (timer noise)")
+    parser.add_argument("--repeats", type=int, default=3, help="Runs of an instance that looks slow, the fastest one counts")
+    parser.add_argument("--update-baseline", action="store_true", help="Overwrite the baseline with this run")
+    args = parser.parse_args()
+
+    baseline = read_baseline(args.baseline)
+    tests = generate_corpus(args.corpus, args.tests)
+
+    results = []
+    regressions = []
+    print(f"{'Test':<30} {'Time':<10} {'Vertices':<10} {'Edges':<10} {'Solution':<10} {'Baseline':<10}")
+    for test_file in tests:
+        test_name = os.path.basename(test_file)
+        with open(test_file) as file:
+            vertices, edges = file.readline().split()[2:4]
+        elapsed, width = run_instance(args.solver_path, test_file, args.timeout)
+        reference = baseline.get(test_name)
+        # A single slow run is often scheduling noise, it only counts if the reruns are slow as well
+        for _ in range(args.repeats - 1):
+            if reference is None or width is None or not is_slow(elapsed, reference, args.slowdown, args.min_time):
+                break
+            elapsed = min(elapsed, run_instance(args.solver_path, test_file, args.timeout)[0])
+        regressions += compare(test_name, elapsed, width, reference, args.slowdown, args.min_time)
+        results.append({"Test": test_name, "Time": f"{elapsed:.3f}", "Vertices": vertices, "Edges": edges,
+                        "Solution": "" if width is None else width})
+        reference_text = f"{reference['Solution']}@{float(reference['Time']):.2f}s" if reference else "-"
+        print(f"{test_name:<30} {elapsed:<10.3f} {vertices:<10} {edges:<10} {str(width):<10} {reference_text:<10}")
+
+    if args.update_baseline:
+        os.makedirs(os.path.dirname(args.baseline) or ".", exist_ok=True)
+        with open(args.baseline, "w", newline="") as file:
+            writer = csv.DictWriter(file, fieldnames=["Test", "Time", "Vertices", "Edges", "Solution"])
+            writer.writeheader()
+            writer.writerows(results)
+        print(f"Baseline written to {args.baseline}")
+        sys.exit(0)
+
+    if regressions:
+        print("\nRegressions:")
+        for regression in regressions:
+            print("  " + regression)
+        sys.exit(1)
+    print("\nNo regressions against " + args.baseline)
@@ -0,0 +1,47 @@
+import argparse
+import csv
+import os
+import sys
+
+from generate_instances import generate_corpus
+from regression import run_instance
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Compare the cost model's heuristic choice against the degree deviation "
+                                                 "rule on instances the model was not fitted on")
+    parser.add_argument("solver_path", type=str, help="Path to the solver executable")
+    parser.add_argument("--corpus", type=str, default="validation.csv", help="Held-out corpus CSV (columns: Test,Family,Params,Seed)")
+    parser.add_argument("--tests", type=str, default="../tests/validation", help="Folder for the generated instances")
+    parser.add_argument("--cost-model", type=str, default=None, help="Model CSV to validate instead of the built-in coefficients")
+    parser.add_argument("--timeout", type=int, default=600, help="Time limit per solver run in seconds")
+    parser.add_argument("--output", type=str, default="baselines/selection_validation.csv", help="Results CSV written by this run")
+    args = parser.parse_args()
+
+    model_options = ["--cost-model", args.cost_model] if args.cost_model else []
+    rows = []
+    print(f"{'Test':<30} {'Model':<8} {'Rule':<8} {'Model s':<10} {'Rule s':<10}")
+    for test_file in generate_corpus(args.corpus, args.tests):
+        test_name = os.path.basename(test_file)
+        model_time, model_width = run_instance(args.solver_path, test_file, args.timeout, model_options)
+        rule_time, rule_width = run_instance(args.solver_path, test_file, args.timeout, ["--no-selection"])
+        rows.append({"Test": test_name, "Model": "" if model_width is None else model_width,
+                     "Rule": "" if rule_width is None else rule_width,
+                     "ModelTime": f"{model_time:.3f}", "RuleTime": f"{rule_time:.3f}"})
+        print(f"{test_name:<30} {str(model_width):<8} {str(rule_width):<8} {model_time:<10.3f} {rule_time:<10.3f}")
+
+    os.makedirs(os.path.dirname(args.output) or ".", exist_ok=True)
+    with open(args.output, "w", newline="") as file:
+        writer = csv.DictWriter(file, fieldnames=["Test", "Model", "Rule", "ModelTime", "RuleTime"])
+        writer.writeheader()
+        writer.writerows(rows)
+
+    # An instance without a valid solution counts as lost for that side
+    better = sum(1 for r in rows if r["Model"] != "" and (r["Rule"] == "" or r["Model"] < r["Rule"]))
+    worse = sum(1 for r in rows if r["Rule"] != "" and (r["Model"] == "" or r["Model"] > r["Rule"]))
+    solved = [r for r in rows if r["Model"] != "" and r["Rule"] != ""]
+    print(f"\nModel better on {better}, worse on {worse}, equal on {len(rows) - better - worse} of {len(rows)} instances")
+    print(f"Total width {sum(r['Model'] for r in solved)} (model) vs {sum(r['Rule'] for r in solved)} (rule), "
+          f"time {sum(float(r['ModelTime']) for r in rows):.1f} s vs {sum(float(r['RuleTime']) for r in rows):.1f} s")
+    print(f"Results written to {args.output}")
+    sys.exit(0 if better >= worse and sum(r["Model"] for r in solved) <= sum(r["Rule"] for r in solved) else 1)
@@ -0,0 +1,163 @@
+#ifndef ADJACENCYPOOL_HPP
+#define ADJACENCYPOOL_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <tuple>
+
+// Compact replacement for vector<vector<int>> adjacency lists. All lists live in a few large blocks of 32-bit
+// entries, every vertex only needs a 16 byte span instead of a vector plus its own heap allocation.
+// Lists grow like vectors (capacity doubles); the span a list leaves behind is kept in a free list of its
+// size class and reused by other growing lists, e.g. red edges created during contraction.
+// Growing one list never moves another one, so iterating a list while appending to other lists is safe.
+class AdjacencyPool {
+    struct Span {
+        uint32_t block = 0;
+        uint32_t offset = 0;
+        uint32_t size = 0;
+        uint32_t capacity = 0;
+    };
+
+public:
+    class List {
+    public:
+        List(AdjacencyPool& pool, int vertex) : pool(pool), vertex(vertex) {}
+
+        int* begin() const { return pool.data(pool.spans[vertex]); }
+        int* end() const { return begin() + size(); }
+        size_t size() const { return pool.spans[vertex].size; }
+        bool empty() const { return size() == 0; }
+        int& operator[](size_t i) const { return begin()[i]; }
+
+        void push_back(int value) {
+            pool.reserve(vertex, size() + 1);
+            Span& span = pool.spans[vertex];
+            pool.data(span)[span.size++] = value;
+        }
+
+        // Reserves exactly capacity entries, used when the final degree is known
+        void reserve(size_t capacity) {
+            pool.reserve(vertex, capacity, true);
+        }
+
+        int* erase(int* first, int* last) {
+            int* listEnd = end();
+            std::memmove(first, last, (listEnd - last) * sizeof(int));
+            pool.spans[vertex].size -= last - first;
+            return first;
+        }
+
+        operator std::vector<int>() const {
+            return std::vector<int>(begin(), end());
+        }
+
+    private:
+        AdjacencyPool& pool;
+        int vertex;
+    };
+
+    class ConstList {
+    public:
+        ConstList(const AdjacencyPool& pool, int vertex) : pool(pool), vertex(vertex) {}
+
+        const int* begin() const { return pool.data(pool.spans[vertex]); }
+        const int* end() const { return begin() + size(); }
+        size_t size() const { return pool.spans[vertex].size; }
+        bool empty() const { return size() == 0; }
+        const int& operator[](size_t i) const { return begin()[i]; }
+
+        operator std::vector<int>() const {
+            return std::vector<int>(begin(), end());
+        }
+
+    private:
+        const AdjacencyPool& pool;
+        int vertex;
+    };
+
+    List operator[](size_t vertex) {
+        return List(*this, vertex);
+    }
+
+    ConstList operator[](size_t vertex) const {
+        return ConstList(*this, vertex);
+    }
+
+    size_t size() const {
+        return spans.size();
+    }
+
+    void resize(size_t n) {
+        spans.resize(n);
+    }
+
+private:
+    static constexpr uint32_t MIN_BLOCK_SIZE = 1 << 8;  // blocks double in size up to MAX_BLOCK_SIZE entries,
+    static constexpr uint32_t MAX_BLOCK_SIZE = 1 << 22; // so small components do not reserve 16 MB each
+    static constexpr int MIN_CAPACITY_CLASS = 2;        // smallest list capacity is 4
+
+    std::vector<Span> spans;
+    std::vector<std::vector<int>> blocks;
+    uint32_t blockUsed = 0; // used entries of the last block
+    uint64_t totalBlockSize = 0;
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> freeSpans = std::vector<std::vector<std::pair<uint32_t, uint32_t>>>(32);
+
+    int* data(const Span& span) {
+        return span.capacity == 0 ? nullptr : blocks[span.block].data() + span.offset;
+    }
+
+    const int* data(const Span& span) const {
+        return span.capacity == 0 ? nullptr : blocks[span.block].data() + span.offset;
+    }
+
+    // Smallest class whose capacity 2^class holds capacity entries
+    static int capacityClass(uint32_t capacity) {
+        int sizeClass = MIN_CAPACITY_CLASS;
+        while ((1u << sizeClass) < capacity) sizeClass++;
+        return sizeClass;
+    }
+
+    // Largest class a freed span of this capacity can serve, -1 if it is too small to be reused
+    static int freeClass(uint32_t capacity) {
+        if (capacity < (1u << MIN_CAPACITY_CLASS)) return -1;
+        int sizeClass = MIN_CAPACITY_CLASS;
+        while ((2u << sizeClass) <= capacity) sizeClass++;
+        return sizeClass;
+    }
+
+    // Growing lists get power of two capacities so that freed spans can be reused, exact ones come from the block tail
+    void reserve(int vertex, uint32_t capacity, bool exact = false) {
+        Span& span = spans[vertex];
+        if (span.capacity >= capacity) return;
+
+        int sizeClass = capacityClass(capacity);
+        uint32_t newCapacity = exact ? capacity : 1u << sizeClass;
+        uint32_t block, offset;
+        if (!exact && !freeSpans[sizeClass].empty()) {
+            std::tie(block, offset) = freeSpans[sizeClass].back();
+            freeSpans[sizeClass].pop_back();
+        }
+        else {
+            if (blocks.empty() || blockUsed + newCapacity > blocks.back().size()) {
+                uint32_t blockSize = std::min<uint64_t>(MAX_BLOCK_SIZE, std::max<uint64_t>(MIN_BLOCK_SIZE, totalBlockSize));
+                blocks.emplace_back(std::max(blockSize, newCapacity));
+                totalBlockSize += blocks.back().size();
+                blockUsed = 0;
+            }
+            block = blocks.size() - 1;
+            offset = blockUsed;
+            blockUsed += newCapacity;
+        }
+
+        int* target = blocks[block].data() + offset;
+        if (span.size > 0) std::memcpy(target, data(span), span.size * sizeof(int));
+        if (freeClass(span.capacity) != -1) freeSpans[freeClass(span.capacity)].push_back({span.block, span.offset});
+        span.block = block;
+        span.offset = offset;
+        span.capacity = newCapacity;
+    }
+};
+
+#endif // ADJACENCYPOOL_HPP
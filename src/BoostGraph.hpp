@@ -69,9 +69,21 @@ public:
         return {components, vertices_in_components};
     }
 
+    // Vertices of every connected component, sorted
+    std::vector<std::vector<int>> getComponentVertices() {
+        std::vector<int> component(num_vertices(g));
+        int num = connected_components(g, &component[0]);
+
+        std::vector<std::vector<int>> vertices_in_components(num);
+        for (size_t i = 0; i < num_vertices(g); ++i) {
+            vertices_in_components[component[i]].push_back(i);
+        }
+        return vertices_in_components;
+    }
+
     bool isBipartite(std::vector<int>& partition1, std::vector<int>& partition2) {
         std::vector<boost::default_color_type> color_map(num_vertices(g));
-        bool is_bipartite = boost::is_bipartite(g, boost::make_iterator_property_map(
+        bool is_bipartite = boost::is_bipartite(g, get(boost::vertex_index, g), boost::make_iterator_property_map(
             color_map.begin(), get(boost::vertex_index, g)));
         
         if (is_bipartite) {
@@ -0,0 +1,90 @@
+#ifndef CACHECOUNTERS_HPP
+#define CACHECOUNTERS_HPP
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#include <cstdint>
+#include <vector>
+
+// Hardware counters for last level cache and data TLB misses (Linux perf_event_open), summed over the calling thread
+// and the given further threads of the process, e.g. the threads of a pool that work for the calling thread.
+// If the kernel does not allow access (e.g. perf_event_paranoid, containers) available() is false and all counts are 0.
+class CacheCounters {
+public:
+    explicit CacheCounters(const std::vector<pid_t>& threads = {}) {
+        std::vector<pid_t> measured = {0};
+        measured.insert(measured.end(), threads.begin(), threads.end());
+        for (pid_t thread : measured) {
+            cacheFds.push_back(open(thread, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES));
+            tlbFds.push_back(open(thread, PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)));
+        }
+    }
+
+    ~CacheCounters() {
+        for (int fd : cacheFds) if (fd != -1) close(fd);
+        for (int fd : tlbFds) if (fd != -1) close(fd);
+    }
+
+    CacheCounters(const CacheCounters&) = delete;
+    CacheCounters& operator=(const CacheCounters&) = delete;
+
+    bool available() const {
+        return cacheFds[0] != -1;
+    }
+
+    void start() {
+        for (const std::vector<int>* fds : {&cacheFds, &tlbFds}) {
+            for (int fd : *fds) {
+                if (fd == -1) continue;
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+    }
+
+    void stop() {
+        cacheMisses = 0;
+        tlbMisses = 0;
+        for (int fd : cacheFds) cacheMisses += read(fd);
+        for (int fd : tlbFds) tlbMisses += read(fd);
+    }
+
+    uint64_t getCacheMisses() const {
+        return cacheMisses;
+    }
+
+    uint64_t getTlbMisses() const {
+        return tlbMisses;
+    }
+
+private:
+    std::vector<int> cacheFds; // one per thread, the calling thread first
+    std::vector<int> tlbFds;
+    uint64_t cacheMisses = 0;
+    uint64_t tlbMisses = 0;
+
+    static int open(pid_t thread, uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return syscall(SYS_perf_event_open, &attr, thread, -1, -1, 0);
+    }
+
+    static uint64_t read(int fd) {
+        if (fd == -1) return 0;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t count = 0;
+        if (::read(fd, &count, sizeof(count)) != sizeof(count)) return 0;
+        return count;
+    }
+};
+
+#endif // CACHECOUNTERS_HPP
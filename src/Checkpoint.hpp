@@ -0,0 +1,293 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include "GraphCache.hpp"
+
+// Checkpoints of a long run in two files:
+//   <path>.seq  journal of the emitted contraction sequence, only appended to between snapshots
+//   <path>      snapshot of the run progress and of the state of the running heuristic (both opaque), replaced atomically
+// Every snapshot records the journal length it belongs to, anything appended after the last snapshot is cut
+// off on resume. The journal is only written together with a snapshot, so each line is written once.
+// Snapshots are rate limited: the time since the last one has to exceed the interval and
+// 100 times the cost of the last snapshot, which keeps checkpointing below 1% of the runtime.
+class Checkpoint {
+public:
+    static const uint32_t VERSION = 2;
+
+    // Appends plain values and lists of them to a byte string
+    class Writer {
+    public:
+        template <class T>
+        void put(const T& value) {
+            data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        // Works for vectors and adjacency lists alike
+        template <class List>
+        void putList(const List& list) {
+            put<uint64_t>(list.size());
+            for (const auto& value : list) put(value);
+        }
+
+        void putString(const std::string& value) {
+            put<uint64_t>(value.size());
+            data.append(value);
+        }
+
+        const std::string& str() const {
+            return data;
+        }
+
+    private:
+        std::string data;
+    };
+
+    // Reads what a Writer wrote, ok() turns false (and all values 0) once the data is exhausted
+    class Reader {
+    public:
+        explicit Reader(const std::string& data) : data(data) {}
+
+        template <class T>
+        T get() {
+            T value{};
+            if (!ok() || position + sizeof(T) > data.size()) {
+                failed = true;
+                return value;
+            }
+            std::memcpy(&value, data.data() + position, sizeof(T));
+            position += sizeof(T);
+            return value;
+        }
+
+        template <class T>
+        std::vector<T> getVector() {
+            uint64_t size = get<uint64_t>();
+            if (!ok() || size > (data.size() - position) / sizeof(T)) {
+                failed = true;
+                return std::vector<T>();
+            }
+            std::vector<T> values(size);
+            if (size > 0) std::memcpy(values.data(), data.data() + position, size * sizeof(T));
+            position += size * sizeof(T);
+            return values;
+        }
+
+        std::string getString() {
+            std::vector<char> chars = getVector<char>();
+            return std::string(chars.begin(), chars.end());
+        }
+
+        bool ok() const {
+            return !failed;
+        }
+
+    private:
+        const std::string& data;
+        size_t position = 0;
+        bool failed = false;
+    };
+
+    Checkpoint() {}
+
+    ~Checkpoint() {
+        close();
+    }
+
+    Checkpoint(const Checkpoint&) = delete;
+    Checkpoint& operator=(const Checkpoint&) = delete;
+
+    bool enabled() const {
+        return journalFd != -1;
+    }
+
+    // Opens the journal. With resume the last snapshot is loaded into progress and state and the journal is cut to its
+    // length, returns false if there is no snapshot for this input and options. Without resume both files start empty.
+    bool open(const std::string& path, const GraphCache::InputIdentity& input, uint32_t options, double intervalSeconds,
+              bool resume, std::string& progress, std::string& state) {
+        close();
+        this->path = path;
+        this->input = input;
+        this->options = options;
+        interval = intervalSeconds;
+        journalFd = ::open((path + ".seq").c_str(), O_RDWR | O_CREAT, 0644);
+        if (journalFd == -1) return false;
+
+        bool loaded = resume && loadSnapshot(progress, state);
+        if (!loaded) {
+            std::remove(path.c_str());
+            journalSize = 0;
+        }
+        if (ftruncate(journalFd, journalSize) != 0) {
+            close();
+            return false;
+        }
+        lastSave = std::chrono::steady_clock::now();
+        return loaded;
+    }
+
+    void close() {
+        if (journalFd != -1) ::close(journalFd);
+        journalFd = -1;
+    }
+
+    uint64_t getJournalSize() const {
+        return journalSize;
+    }
+
+    std::string readJournal(uint64_t begin, uint64_t end) const {
+        std::string text(end - begin, '\0');
+        if (!text.empty() && pread(journalFd, &text[0], text.size(), begin) != (ssize_t)text.size()) text.clear();
+        return text;
+    }
+
+    bool append(const std::string& text) {
+        if (text.empty()) return true;
+        if (pwrite(journalFd, text.data(), text.size(), journalSize) != (ssize_t)text.size()) return false;
+        journalSize += text.size();
+        return true;
+    }
+
+    // Serialises the progress of the whole run, called for every snapshot
+    void setProgress(const std::function<std::string()>& progress) {
+        this->progress = progress;
+    }
+
+    // The sequence passed to saveSequence from now on is journaled starting at the current end of the journal
+    void startSequence() {
+        sequenceStart = journalSize;
+    }
+
+    bool due() const {
+        if (!enabled()) return false;
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - lastSave).count();
+        return elapsed >= std::max(interval, 100 * lastCost);
+    }
+
+    // Appends the part of sequence that is not journaled yet and writes a snapshot with the heuristic state.
+    // The state is only serialised here so that its cost counts towards the rate limit.
+    bool saveSequence(const std::string& sequence, const std::function<std::string()>& state) {
+        auto start = std::chrono::steady_clock::now();
+        uint64_t written = journalSize - sequenceStart;
+        bool ok = (sequence.size() <= written || append(sequence.substr(written))) && write(state());
+        finishSave(start);
+        return ok;
+    }
+
+    // Writes a snapshot without heuristic state, e.g. after a component is finished
+    bool save() {
+        auto start = std::chrono::steady_clock::now();
+        bool ok = write("");
+        finishSave(start);
+        return ok;
+    }
+
+    int getSaves() const {
+        return saves;
+    }
+
+    double getTotalCost() const {
+        return totalCost;
+    }
+
+private:
+    static constexpr const char* MAGIC = "TWWCKPT1";
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t options;
+        GraphCache::InputIdentity input;
+        uint64_t journalSize;
+        uint64_t progressSize;
+        uint64_t stateSize;
+        uint64_t payloadChecksum;
+    };
+
+    std::string path;
+    std::function<std::string()> progress;
+    GraphCache::InputIdentity input;
+    uint32_t options = 0;
+    int journalFd = -1;
+    uint64_t journalSize = 0;
+    uint64_t sequenceStart = 0;
+    double interval = 0;
+    double lastCost = 0;
+    double totalCost = 0;
+    int saves = 0;
+    std::chrono::steady_clock::time_point lastSave;
+
+    void finishSave(const std::chrono::steady_clock::time_point& start) {
+        lastSave = std::chrono::steady_clock::now();
+        lastCost = std::chrono::duration<double>(lastSave - start).count();
+        totalCost += lastCost;
+        saves++;
+    }
+
+    // Writes a snapshot for the current journal length. The snapshot goes to a temporary file first,
+    // so an interrupted write leaves the previous snapshot intact.
+    bool write(const std::string& state) {
+        Header header;
+        std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+        header.version = VERSION;
+        header.options = options;
+        header.input = input;
+        std::string payload = progress ? progress() : std::string();
+        header.journalSize = journalSize;
+        header.progressSize = payload.size();
+        header.stateSize = state.size();
+        payload += state;
+        header.payloadChecksum = GraphCache::hash(payload.data(), payload.size());
+
+        std::string tmpPath = path + ".tmp";
+        FILE* file = std::fopen(tmpPath.c_str(), "wb");
+        if (file == nullptr) return false;
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+                  && std::fwrite(payload.data(), 1, payload.size(), file) == payload.size();
+        ok = (std::fclose(file) == 0) && ok;
+        if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    bool loadSnapshot(std::string& progress, std::string& state) {
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr) return false;
+        Header header;
+        bool ok = std::fread(&header, sizeof(header), 1, file) == 1
+                  && std::memcmp(header.magic, MAGIC, sizeof(header.magic)) == 0 && header.version == VERSION
+                  && header.options == options && header.input.size == input.size
+                  && header.input.modified == input.modified && header.input.hash == input.hash;
+        std::string payload;
+        if (ok && header.progressSize + header.stateSize < (1ULL << 40)) {
+            payload.assign(header.progressSize + header.stateSize, '\0');
+            ok = std::fread(&payload[0], 1, payload.size(), file) == payload.size()
+                 && std::fgetc(file) == EOF
+                 && GraphCache::hash(payload.data(), payload.size()) == header.payloadChecksum;
+        }
+        else ok = false;
+        std::fclose(file);
+
+        struct stat journalStat;
+        ok = ok && fstat(journalFd, &journalStat) == 0 && (uint64_t)journalStat.st_size >= header.journalSize;
+        if (!ok) return false;
+        progress = payload.substr(0, header.progressSize);
+        state = payload.substr(header.progressSize);
+        journalSize = header.journalSize;
+        return true;
+    }
+};
+
+#endif // CHECKPOINT_HPP
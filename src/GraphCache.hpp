@@ -0,0 +1,195 @@
+#ifndef GRAPHCACHE_HPP
+#define GRAPHCACHE_HPP
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Versioned binary cache of a parsed instance, loaded with mmap.
+// Payload (every array starts 8-byte aligned):
+//   adjacencyOffsets[n + 1] (uint64), adjacency[2m] (int32)       CSR adjacency of the graph that is solved
+//   componentOffsets[k + 1] (uint64), componentIds[n] (int32)     local index -> global id, component by component
+//   localIndex[n] (int32)                                         global id -> local index in its component
+//   twinData[t] (int32)                                           per class: component, kind, size, local members
+// The header identifies the input (size and modification time of a regular file, or a hash of piped input),
+// the solver options the partition depends on and a checksum of the payload.
+class GraphCache {
+public:
+    static const uint32_t VERSION = 1;
+
+    struct InputIdentity {
+        uint64_t size = 0;
+        int64_t modified = 0;
+        uint64_t hash = 0;
+    };
+
+    GraphCache() {}
+
+    ~GraphCache() {
+        close();
+    }
+
+    GraphCache(const GraphCache&) = delete;
+    GraphCache& operator=(const GraphCache&) = delete;
+
+    // Word-wise multiplicative hash, fast enough to check multi-GB payloads on load
+    static uint64_t hash(const char* data, size_t size) {
+        uint64_t h = 1469598103934665603ULL;
+        size_t words = size / 8;
+        for (size_t i = 0; i < words; ++i) {
+            uint64_t word;
+            std::memcpy(&word, data + 8 * i, 8);
+            h = (h ^ word) * 1099511628211ULL;
+            h ^= h >> 29;
+        }
+        for (size_t i = 8 * words; i < size; ++i) {
+            h = (h ^ static_cast<unsigned char>(data[i])) * 1099511628211ULL;
+        }
+        return h;
+    }
+
+    static bool write(const std::string& path, const InputIdentity& input, uint32_t options,
+                      const std::vector<uint64_t>& adjacencyOffsets, const std::vector<int32_t>& adjacency,
+                      const std::vector<uint64_t>& componentOffsets, const std::vector<int32_t>& componentIds,
+                      const std::vector<int32_t>& localIndex, const std::vector<int32_t>& twinData) {
+        std::string payload;
+        append(payload, adjacencyOffsets);
+        append(payload, adjacency);
+        append(payload, componentOffsets);
+        append(payload, componentIds);
+        append(payload, localIndex);
+        append(payload, twinData);
+
+        Header header;
+        std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+        header.version = VERSION;
+        header.options = options;
+        header.input = input;
+        header.numVertices = localIndex.size();
+        header.numAdjacency = adjacency.size();
+        header.numComponents = componentOffsets.size() - 1;
+        header.numTwinEntries = twinData.size();
+        header.payloadChecksum = hash(payload.data(), payload.size());
+
+        // Write to a temporary file first so that an interrupted write never leaves a valid looking cache
+        std::string tmpPath = path + ".tmp";
+        FILE* file = std::fopen(tmpPath.c_str(), "wb");
+        if (file == nullptr) return false;
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+                  && std::fwrite(payload.data(), 1, payload.size(), file) == payload.size();
+        ok = (std::fclose(file) == 0) && ok;
+        if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // Maps the cache, returns false if it is missing, was written for another input or options, or is corrupt
+    bool open(const std::string& path, const InputIdentity& input, uint32_t options) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(Header)) {
+            ::close(fd);
+            return false;
+        }
+        mappedSize = st.st_size;
+        void* mapping = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) return false;
+        data = static_cast<const char*>(mapping);
+
+        const Header* header = reinterpret_cast<const Header*>(data);
+        if (std::memcmp(header->magic, MAGIC, sizeof(header->magic)) != 0 || header->version != VERSION
+            || header->options != options || header->input.size != input.size
+            || header->input.modified != input.modified || header->input.hash != input.hash) {
+            close();
+            return false;
+        }
+
+        size_t offset = sizeof(Header);
+        uint64_t n = header->numVertices;
+        adjacencyOffsets = section<uint64_t>(offset, n + 1);
+        adjacency = section<int32_t>(offset, header->numAdjacency);
+        componentOffsets = section<uint64_t>(offset, header->numComponents + 1);
+        componentIds = section<int32_t>(offset, n);
+        localIndex = section<int32_t>(offset, n);
+        twinData = section<int32_t>(offset, header->numTwinEntries);
+        if (offset != mappedSize
+            || hash(data + sizeof(Header), mappedSize - sizeof(Header)) != header->payloadChecksum) {
+            close();
+            return false;
+        }
+
+        numVertices = n;
+        numComponents = header->numComponents;
+        numTwinEntries = header->numTwinEntries;
+        return true;
+    }
+
+    void close() {
+        if (data != nullptr) munmap(const_cast<char*>(data), mappedSize);
+        data = nullptr;
+        mappedSize = 0;
+    }
+
+    uint64_t numVertices = 0;
+    uint64_t numComponents = 0;
+    uint64_t numTwinEntries = 0;
+    const uint64_t* adjacencyOffsets = nullptr;
+    const int32_t* adjacency = nullptr;
+    const uint64_t* componentOffsets = nullptr;
+    const int32_t* componentIds = nullptr;
+    const int32_t* localIndex = nullptr;
+    const int32_t* twinData = nullptr;
+
+private:
+    static constexpr const char* MAGIC = "TWWCACHE";
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t options;
+        InputIdentity input;
+        uint64_t numVertices;
+        uint64_t numAdjacency;
+        uint64_t numComponents;
+        uint64_t numTwinEntries;
+        uint64_t payloadChecksum;
+    };
+
+    const char* data = nullptr;
+    size_t mappedSize = 0;
+
+    template <class T>
+    static void append(std::string& payload, const std::vector<T>& values) {
+        payload.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+        payload.resize((payload.size() + 7) / 8 * 8, '\0');
+    }
+
+    // Returns the next array of count values and advances offset, nullptr if the file is too short
+    template <class T>
+    const T* section(size_t& offset, uint64_t count) {
+        size_t begin = offset;
+        if (offset > mappedSize || count > mappedSize) {
+            offset = SIZE_MAX;
+            return nullptr;
+        }
+        offset += (count * sizeof(T) + 7) / 8 * 8;
+        if (offset > mappedSize) {
+            offset = SIZE_MAX;
+            return nullptr;
+        }
+        return reinterpret_cast<const T*>(data + begin);
+    }
+};
+
+#endif // GRAPHCACHE_HPP
@@ -0,0 +1,132 @@
+#ifndef HEURISTICSELECTION_HPP
+#define HEURISTICSELECTION_HPP
+
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+
+enum Engine { DEGREE_ENGINE, RANDOM_WALK_ENGINE, BIPARTITE_ENGINE, ENGINE_COUNT };
+
+inline const char* engineName(Engine engine) {
+    static const char* names[ENGINE_COUNT] = {"degree", "walk", "bipartite"};
+    return names[engine];
+}
+
+// Engines the cost model chooses from. The bipartite engine only runs with bipartiteContraction (or --engine), the
+// synthetic corpus has too few bipartite components to fit it.
+inline bool isModelled(Engine engine) {
+    return engine == DEGREE_ENGINE || engine == RANDOM_WALK_ENGINE;
+}
+
+// ENGINE_COUNT if the name is unknown
+inline Engine engineFromName(const std::string& name) {
+    for (int e = 0; e < ENGINE_COUNT; ++e) {
+        if (name == engineName(static_cast<Engine>(e))) return static_cast<Engine>(e);
+    }
+    return ENGINE_COUNT;
+}
+
+// Features of a component that can be computed in O(n + m) before a heuristic is chosen
+struct ComponentFeatures {
+    int vertices = 0;
+    long long edges = 0;
+    double meanDegree = 0;
+    int maxDegree = 0;
+    double degreeDeviation = 0; // mean absolute deviation of the degrees
+    bool bipartite = false;
+    double twinRatio = 0;       // share of vertices with a true or false twin
+    double clustering = 0;      // share of closed paths of length 2, estimated from random ones
+
+    static constexpr int SIZE = 9;
+    static constexpr int CLUSTERING_SAMPLES = 2000;         // max. random paths of the clustering estimate
+    static constexpr int CLUSTERING_SAMPLES_PER_VERTEX = 4; // and max. per vertex, so small components stay O(n)
+
+    // Inputs of the cost model, the first one is the intercept
+    std::vector<double> values() const {
+        return {1.0, std::log(vertices + 1.0), std::log(edges + 1.0), meanDegree, std::log(maxDegree + 1.0),
+                degreeDeviation, bipartite ? 1.0 : 0.0, twinRatio, clustering};
+    }
+};
+
+// Predicts runtime and width of the modelled engines on a component with linear models over ComponentFeatures::values():
+// ln(seconds) for the runtime, so that the fit covers components of very different sizes, and the width itself.
+// The coefficients are fitted by scripts/calibrate_costs.py from runs with forced engines, the built-in ones are copied
+// from scripts/baselines/cost_model.csv.
+class CostModel {
+public:
+    CostModel() {
+        logSeconds[DEGREE_ENGINE] = {-10.34, 0.6313, 0.5072, 0.002181, 0.02099, -0.01108, -0.1516, -0.3736, -0.4063};
+        logSeconds[RANDOM_WALK_ENGINE] = {-10.54, 0.6208, 0.5133, 0.001377, 0.2141, -0.004323, -0.2447, -0.3761, -0.6536};
+        width[DEGREE_ENGINE] = {-31.33, -4.586, 11.56, -0.09541, 7.295, -1.162, -17.87, -28.59, -19.63};
+        width[RANDOM_WALK_ENGINE] = {-16.85, -11.35, 12.83, -0.03589, 18.74, -1.813, -23.16, -45.9, -43.98};
+    }
+
+    // Reads the CSV written by scripts/calibrate_costs.py (Engine,Target,<one column per feature>),
+    // engines missing from the file keep their coefficients
+    bool load(const std::string& path) {
+        std::ifstream file(path);
+        std::string line;
+        if (!std::getline(file, line)) return false;
+        CostModel loaded = *this;
+        while (std::getline(file, line)) {
+            std::istringstream row(line);
+            std::string name, target, cell;
+            std::getline(row, name, ',');
+            std::getline(row, target, ',');
+            std::vector<double> coefficients;
+            while (std::getline(row, cell, ',')) coefficients.push_back(std::strtod(cell.c_str(), nullptr));
+            Engine engine = engineFromName(name);
+            if (!isModelled(engine) || coefficients.size() != ComponentFeatures::SIZE) return false;
+            if (target == "log_seconds") loaded.logSeconds[engine] = coefficients;
+            else if (target == "width") loaded.width[engine] = coefficients;
+            else return false;
+        }
+        *this = loaded;
+        return true;
+    }
+
+    double predictSeconds(Engine engine, const ComponentFeatures& features) const {
+        return std::exp(evaluate(logSeconds[engine], features));
+    }
+
+    double predictWidth(Engine engine, const ComponentFeatures& features) const {
+        return std::max(0.0, evaluate(width[engine], features));
+    }
+
+    // The modelled engine with the lowest predicted width among those predicted to finish within budgetSeconds,
+    // the fastest one if none of them does. A preferred engine that fits the budget is kept unless another one is
+    // predicted to be better by more than margin, the width predictions are too coarse to decide close cases.
+    Engine select(const ComponentFeatures& features, double budgetSeconds, Engine preferred = ENGINE_COUNT,
+                  double margin = 0) const {
+        Engine best = ENGINE_COUNT;
+        Engine fastest = ENGINE_COUNT;
+        for (int e = 0; e < ENGINE_COUNT; ++e) {
+            Engine engine = static_cast<Engine>(e);
+            if (!isModelled(engine)) continue;
+            if (fastest == ENGINE_COUNT || predictSeconds(engine, features) < predictSeconds(fastest, features)) fastest = engine;
+            if (predictSeconds(engine, features) <= budgetSeconds
+                && (best == ENGINE_COUNT || predictWidth(engine, features) < predictWidth(best, features))) best = engine;
+        }
+        if (best == ENGINE_COUNT) return fastest;
+        if (isModelled(preferred) && predictSeconds(preferred, features) <= budgetSeconds
+            && predictWidth(best, features) >= predictWidth(preferred, features) - margin) return preferred;
+        return best;
+    }
+
+private:
+    std::vector<double> logSeconds[ENGINE_COUNT];
+    std::vector<double> width[ENGINE_COUNT];
+
+    static double evaluate(const std::vector<double>& coefficients, const ComponentFeatures& features) {
+        std::vector<double> values = features.values();
+        double result = 0;
+        for (int i = 0; i < ComponentFeatures::SIZE; ++i) result += coefficients[i] * values[i];
+        return result;
+    }
+};
+
+#endif // HEURISTICSELECTION_HPP
@@ -0,0 +1,184 @@
+#ifndef LOWERBOUND_HPP
+#define LOWERBOUND_HPP
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <numeric>
+#include <climits>
+
+// Lower bounds on the twin-width of a single (black) graph.
+// Twin-width is monotone under induced subgraphs and the first contraction of any sequence
+// creates a red degree equal to the score of the contracted pair, so for every induced subgraph H
+// the minimum pair score inside H is a lower bound for the whole graph.
+class LowerBound {
+public:
+    LowerBound(const std::vector<std::vector<int>>& adjacency) : adj(adjacency), inSubgraph(adjacency.size(), -1) {
+        for (auto& neighbors : adj) {
+            std::sort(neighbors.begin(), neighbors.end());
+        }
+    }
+
+    int get() const {
+        return bound.load();
+    }
+
+    // Runs all stages until they are exhausted, the bound reaches upperBound or stop is set
+    int compute(const std::atomic<int>& upperBound, const std::atomic<bool>& stop) {
+        this->upperBound = &upperBound;
+        this->stop = &stop;
+
+        if (adj.size() <= MAX_SUBGRAPH_SIZE) {
+            std::vector<int> all(adj.size());
+            std::iota(all.begin(), all.end(), 0);
+            raise(minPairScore(all));
+        }
+        if (get() == 0 && hasInducedP4()) {
+            raise(1);
+        }
+
+        // Dense parts first: k-cores from the innermost one outwards
+        std::vector<int> core = coreNumbers();
+        std::vector<int> order(adj.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&core](int a, int b) { return core[a] > core[b]; });
+        for (size_t end = 0; end < order.size() && !done();) {
+            int k = core[order[end]];
+            while (end < order.size() && core[order[end]] == k) end++;
+            if (end > MAX_SUBGRAPH_SIZE) break;
+            if (end < 2 || end == adj.size()) continue;
+            raise(minPairScore(std::vector<int>(order.begin(), order.begin() + end)));
+        }
+
+        // Closed neighbourhoods of the highest degree vertices
+        std::sort(order.begin(), order.end(), [this](int a, int b) { return adj[a].size() > adj[b].size(); });
+        for (int i = 0; i < std::min<int>(order.size(), MAX_NEIGHBORHOODS) && !done(); ++i) {
+            int v = order[i];
+            if (adj[v].size() + 1 > MAX_SUBGRAPH_SIZE) continue;
+            std::vector<int> neighborhood = adj[v];
+            neighborhood.push_back(v);
+            raise(minPairScore(neighborhood));
+        }
+        return get();
+    }
+
+private:
+    static constexpr size_t MAX_SUBGRAPH_SIZE = 1500;
+    static constexpr int MAX_NEIGHBORHOODS = 50;
+
+    std::vector<std::vector<int>> adj;
+    std::vector<int> inSubgraph; // local index of a vertex in the current subgraph, -1 if outside
+    std::atomic<int> bound{0};
+    const std::atomic<int>* upperBound = nullptr;
+    const std::atomic<bool>* stop = nullptr;
+
+    bool done() const {
+        return stop->load() || bound.load() >= upperBound->load();
+    }
+
+    void raise(int value) {
+        int current = bound.load();
+        while (value > current && !bound.compare_exchange_weak(current, value)) {}
+    }
+
+    // Minimum over all pairs of |N(u) xor N(v) \ {u, v}| inside the subgraph induced by subset
+    int minPairScore(const std::vector<int>& subset) {
+        for (size_t i = 0; i < subset.size(); ++i) inSubgraph[subset[i]] = i;
+
+        std::vector<std::vector<int>> local(subset.size());
+        for (size_t i = 0; i < subset.size(); ++i) {
+            for (int u : adj[subset[i]]) {
+                if (inSubgraph[u] != -1) local[i].push_back(inSubgraph[u]);
+            }
+            std::sort(local[i].begin(), local[i].end());
+        }
+        for (int v : subset) inSubgraph[v] = -1;
+
+        // Vertices sorted by degree, pairs with a large degree gap cannot beat the current minimum
+        std::vector<int> byDegree(subset.size());
+        std::iota(byDegree.begin(), byDegree.end(), 0);
+        std::sort(byDegree.begin(), byDegree.end(), [&local](int a, int b) { return local[a].size() < local[b].size(); });
+
+        int minScore = INT_MAX;
+        for (size_t i = 0; i < byDegree.size() && minScore > get(); ++i) {
+            if (done()) return 0;
+            int u = byDegree[i];
+            for (size_t j = i + 1; j < byDegree.size(); ++j) {
+                int v = byDegree[j];
+                if ((int)local[v].size() - (int)local[u].size() - 2 >= minScore) break;
+                minScore = std::min(minScore, symmetricDifference(local[u], local[v], u, v, minScore));
+            }
+        }
+        return minScore == INT_MAX ? 0 : minScore;
+    }
+
+    static int symmetricDifference(const std::vector<int>& a, const std::vector<int>& b, int u, int v, int limit) {
+        int count = 0;
+        auto i = a.begin(), j = b.begin();
+        while ((i != a.end() || j != b.end()) && count < limit) {
+            int x;
+            if (j == b.end() || (i != a.end() && *i < *j)) x = *i++;
+            else if (i == a.end() || *j < *i) x = *j++;
+            else { ++i; ++j; continue; }
+            if (x != u && x != v) count++;
+        }
+        return count;
+    }
+
+    // Forbidden pattern for width 0: a graph has twin-width 0 iff it is a cograph, i.e. has no induced P4 a-u-v-b
+    bool hasInducedP4() {
+        long long budget = 50000000;
+        for (int u = 0; u < static_cast<int>(adj.size()); ++u) {
+            for (int v : adj[u]) {
+                for (int a : adj[u]) {
+                    if (a == v || adjacent(a, v)) continue;
+                    for (int b : adj[v]) {
+                        if (--budget < 0 || done()) return false;
+                        if (b != u && b != a && !adjacent(b, u) && !adjacent(a, b)) return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    bool adjacent(int u, int v) const {
+        return std::binary_search(adj[u].begin(), adj[u].end(), v);
+    }
+
+    // Core number of every vertex (bucket based peeling, degeneracy ordering)
+    std::vector<int> coreNumbers() const {
+        int n = adj.size();
+        std::vector<int> degree(n), core(n);
+        int maxDegree = 0;
+        for (int v = 0; v < n; ++v) {
+            degree[v] = adj[v].size();
+            maxDegree = std::max(maxDegree, degree[v]);
+        }
+
+        std::vector<std::vector<int>> buckets(maxDegree + 1);
+        for (int v = 0; v < n; ++v) buckets[degree[v]].push_back(v);
+
+        std::vector<bool> removed(n, false);
+        int k = 0;
+        for (int d = 0; d <= maxDegree;) {
+            if (buckets[d].empty()) { d++; continue; }
+            int v = buckets[d].back();
+            buckets[d].pop_back();
+            if (removed[v] || degree[v] != d) continue;
+            removed[v] = true;
+            k = std::max(k, d);
+            core[v] = k;
+            for (int u : adj[v]) {
+                if (!removed[u] && degree[u] > 0) {
+                    degree[u]--;
+                    buckets[degree[u]].push_back(u);
+                    if (degree[u] < d) d = degree[u];
+                }
+            }
+        }
+        return core;
+    }
+};
+
+#endif // LOWERBOUND_HPP
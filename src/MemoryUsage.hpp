@@ -0,0 +1,40 @@
+#ifndef MEMORYUSAGE_HPP
+#define MEMORYUSAGE_HPP
+
+#include <fstream>
+#include <string>
+#include <sstream>
+
+// Resident set size of this process read from /proc/self/status (Linux), all values in kB, 0 if unavailable
+namespace MemoryUsage {
+    inline long readStatusField(const std::string& field) {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.compare(0, field.size(), field) == 0 && line[field.size()] == ':') {
+                std::istringstream value(line.substr(field.size() + 1));
+                long kb = 0;
+                value >> kb;
+                return kb;
+            }
+        }
+        return 0;
+    }
+
+    inline long currentRssKb() {
+        return readStatusField("VmRSS");
+    }
+
+    inline long peakRssKb() {
+        return readStatusField("VmHWM");
+    }
+
+    // Resets the peak to the current RSS so that the next peakRssKb() only covers the following phase
+    inline bool resetPeakRss() {
+        std::ofstream clearRefs("/proc/self/clear_refs");
+        clearRefs << "5";
+        return static_cast<bool>(clearRefs);
+    }
+}
+
+#endif // MEMORYUSAGE_HPP
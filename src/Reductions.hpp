@@ -0,0 +1,247 @@
+#ifndef REDUCTIONS_HPP
+#define REDUCTIONS_HPP
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+// Reduction rules for a graph without red edges whose contractions are known in advance. None of them creates a red
+// degree above 2, every rule runs once in O(n + m):
+//   - degree-1 vertices with the same neighbour are twins and are contracted into one
+//   - a tree that is left is contracted completely in DFS post-order from a leaf that ends a longest path, every
+//     collapsed subtree is merged into its collapsed sibling right away, so no vertex has more than two red edges.
+//     The pendant twins go first, a star then is a single edge and keeps width 0
+//   - the inner vertices of a path x1, ..., xk of at least PATH_MIN_LENGTH degree-2 vertices are contracted into x2,
+//     which leaves x1 -red- x2 -red- xk
+// Contractions are (kept vertex, removed vertex) pairs of indices into the adjacency.
+class Reductions {
+public:
+    static constexpr int PATH_MIN_LENGTH = 4;
+
+    explicit Reductions(const std::vector<std::vector<int>>& adjacency)
+        : adj(adjacency), removed(adjacency.size(), false), onlyRed(adjacency.size(), false),
+          red(adjacency.size()), degree(adjacency.size()) {
+        for (size_t v = 0; v < adj.size(); ++v) degree[v] = adj[v].size();
+    }
+
+    void run(bool paths) {
+        contractPendants();
+        if (contractTree()) return;
+        if (paths) contractPaths();
+    }
+
+    const std::vector<std::pair<int, int>>& getContractions() const {
+        return contractions;
+    }
+
+    int getWidth() const {
+        return width;
+    }
+
+    int getTreeContractions() const {
+        return treeContractions;
+    }
+
+    int getPendantContractions() const {
+        return pendantContractions;
+    }
+
+    int getPathContractions() const {
+        return pathContractions;
+    }
+
+    std::vector<int> getKernel() const {
+        std::vector<int> kernel;
+        for (size_t v = 0; v < adj.size(); ++v) {
+            if (!removed[v]) kernel.push_back(v);
+        }
+        return kernel;
+    }
+
+    // Black and red neighbours of v in the kernel
+    std::vector<int> getBlackNeighbors(int v) const {
+        std::vector<int> neighbors;
+        if (onlyRed[v]) return neighbors;
+        for (int u : adj[v]) {
+            if (!removed[u] && !onlyRed[u]) neighbors.push_back(u);
+        }
+        return neighbors;
+    }
+
+    const std::vector<int>& getRedNeighbors(int v) const {
+        return red[v];
+    }
+
+private:
+    const std::vector<std::vector<int>>& adj;
+    std::vector<bool> removed;
+    std::vector<bool> onlyRed;          // all remaining edges of the vertex are in red
+    std::vector<std::vector<int>> red;
+    std::vector<int> degree;            // number of remaining neighbours
+    std::vector<std::pair<int, int>> contractions;
+    int width = 0;
+    int treeContractions = 0;
+    int pendantContractions = 0;
+    int pathContractions = 0;
+
+    void contract(int source, int twin) {
+        contractions.push_back({source, twin});
+        removed[twin] = true;
+    }
+
+    // Runs on the vertices left by contractPendants, degree counts only those
+    bool contractTree() {
+        int n = adj.size();
+        int remaining = 0;
+        long long edges = 0;
+        for (int v = 0; v < n; ++v) {
+            if (removed[v]) continue;
+            remaining++;
+            edges += degree[v];
+        }
+        if (remaining < 2 || edges != 2LL * (remaining - 1)) return false;
+
+        // DFS from the end of a longest path (the last vertex a BFS reaches), a path then never gets more than one
+        // red edge per vertex and neither does the spine of a caterpillar
+        int root = 0;
+        while (removed[root]) root++;
+        std::vector<int> queue = {root};
+        std::vector<bool> reached(n, false);
+        reached[root] = true;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            for (int u : adj[queue[head]]) {
+                if (!removed[u] && !reached[u]) {
+                    reached[u] = true;
+                    queue.push_back(u);
+                }
+            }
+        }
+        root = queue.back();
+        std::vector<int> parent(n, -1);
+        std::vector<int> order;
+        order.reserve(n);
+        std::vector<int> stack = {root};
+        std::vector<bool> visited(n, false);
+        visited[root] = true;
+        std::vector<size_t> next(n, 0);
+        while (!stack.empty()) {
+            int v = stack.back();
+            if (next[v] < adj[v].size()) {
+                int u = adj[v][next[v]++];
+                if (!removed[u] && !visited[u]) {
+                    visited[u] = true;
+                    parent[u] = v;
+                    stack.push_back(u);
+                }
+            }
+            else {
+                order.push_back(v);
+                stack.pop_back();
+            }
+        }
+        if (order.size() != static_cast<size_t>(remaining)) return false; // a forest with a cycle elsewhere
+
+        // collapsed[v]: the collapsed child subtree still attached to v (-1 if none), isRed: edge to the parent is red
+        std::vector<int> collapsed(n, -1);
+        std::vector<bool> isRed(n, false);
+        std::vector<int> redChildren(n, 0);
+        for (int v : order) {
+            if (collapsed[v] != -1) {
+                contract(v, collapsed[v]);
+                if (isRed[collapsed[v]]) redChildren[v]--;
+                if (v == root) break;
+                isRed[v] = true;
+                width = std::max(width, 1);
+            }
+            int p = parent[v];
+            if (isRed[v]) width = std::max(width, ++redChildren[p]);
+            if (collapsed[p] == -1) {
+                collapsed[p] = v;
+            }
+            else {
+                int sibling = collapsed[p];
+                contract(sibling, v);
+                if (isRed[sibling] && isRed[v]) redChildren[p]--;
+                isRed[sibling] = isRed[sibling] || isRed[v];
+            }
+        }
+        treeContractions = contractions.size() - pendantContractions;
+        return true;
+    }
+
+    void contractPendants() {
+        for (size_t p = 0; p < adj.size(); ++p) {
+            int kept = -1;
+            for (int l : adj[p]) {
+                if (removed[l] || adj[l].size() != 1) continue;
+                if (kept == -1) kept = l;
+                else {
+                    contract(kept, l);
+                    degree[p]--;
+                    pendantContractions++;
+                }
+            }
+        }
+    }
+
+    bool onPath(int v) const {
+        return !removed[v] && degree[v] == 2 && red[v].empty();
+    }
+
+    // The neighbour of v on a path that is not previous
+    int nextOnPath(int v, int previous) const {
+        for (int u : adj[v]) {
+            if (!removed[u] && u != previous) return u;
+        }
+        return -1;
+    }
+
+    void contractPaths() {
+        std::vector<bool> visited(adj.size(), false);
+        for (int v = 0; v < static_cast<int>(adj.size()); ++v) {
+            if (visited[v] || !onPath(v)) continue;
+
+            // Walk to one end of the path, then collect it from there
+            int previous = nextOnPath(v, -1);
+            int current = v;
+            while (onPath(previous) && previous != v) {
+                int before = nextOnPath(previous, current);
+                current = previous;
+                previous = before;
+            }
+            if (previous == v) {
+                // The whole component is a cycle of degree-2 vertices
+                for (int u = v, last = current; !visited[u];) {
+                    visited[u] = true;
+                    int following = nextOnPath(u, last);
+                    last = u;
+                    u = following;
+                }
+                continue;
+            }
+
+            std::vector<int> path;
+            while (onPath(current) && !visited[current]) {
+                visited[current] = true;
+                path.push_back(current);
+                int following = nextOnPath(current, previous);
+                previous = current;
+                current = following;
+            }
+            if (path.size() < PATH_MIN_LENGTH) continue;
+
+            int k = path.size();
+            for (int i = 2; i < k - 1; ++i) {
+                contract(path[1], path[i]);
+                pathContractions++;
+            }
+            onlyRed[path[1]] = true;
+            red[path[1]] = {path[0], path[k - 1]};
+            red[path[0]].push_back(path[1]);
+            red[path[k - 1]].push_back(path[1]);
+            width = std::max(width, 2);
+        }
+    }
+};
+
+#endif // REDUCTIONS_HPP
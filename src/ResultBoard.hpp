@@ -0,0 +1,168 @@
+#ifndef RESULTBOARD_HPP
+#define RESULTBOARD_HPP
+
+#include <sys/mman.h>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <new>
+
+// Task queue and results of the worker processes of a run, kept in a shared anonymous mapping that is created before
+// the workers are forked:
+//   header        claim counter over the task order, predicted seconds of the tasks not claimed yet
+//   slots[t]      state, worker, width and sequence length of task t
+//   order[]       the order in which tasks are claimed, fixed while workers run
+//   arena         every task owns a fixed range for its contraction sequence
+// Claiming a task is a single fetch_add on the counter. A worker writes the sequence into its range and then
+// publishes the slot by setting its state with release semantics, so the coordinator only reads finished slots.
+// Nothing is locked, a worker that dies leaves its task CLAIMED (or PENDING) and the coordinator can hand it out again.
+class ResultBoard {
+public:
+    enum State { PENDING, CLAIMED, DONE };
+
+    struct Slot {
+        std::atomic<int> state;
+        std::atomic<int> worker;
+        int width;
+        int remainingVertex;  // vertex left after the sequence, 1-based like the output
+        double predictedSeconds;
+        uint64_t offset;      // sequence range in the arena
+        uint64_t capacity;
+        uint64_t length;
+    };
+
+    static_assert(std::atomic<int>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free
+                  && std::atomic<int64_t>::is_always_lock_free, "the board needs address-free atomics");
+
+    ResultBoard() {}
+
+    ~ResultBoard() {
+        close();
+    }
+
+    ResultBoard(const ResultBoard&) = delete;
+    ResultBoard& operator=(const ResultBoard&) = delete;
+
+    // capacities[t] is the maximum length of the sequence of task t. The arena is reserved, not committed:
+    // only the pages that sequences are written to take memory.
+    bool create(const std::vector<uint64_t>& capacities, const std::vector<double>& predictedSeconds) {
+        close();
+        numTasks = capacities.size();
+        uint64_t arenaSize = 0;
+        for (uint64_t capacity : capacities) arenaSize += capacity;
+        size_t slotsOffset = align(sizeof(Header));
+        size_t orderOffset = slotsOffset + align(numTasks * sizeof(Slot));
+        size_t arenaOffset = orderOffset + align(numTasks * sizeof(int32_t));
+        mappedSize = arenaOffset + std::max<uint64_t>(arenaSize, 1);
+        void* mapping = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (mapping == MAP_FAILED) {
+            mappedSize = 0;
+            return false;
+        }
+        data = static_cast<char*>(mapping);
+        header = new (data) Header();
+        slots = reinterpret_cast<Slot*>(data + slotsOffset);
+        order = reinterpret_cast<int32_t*>(data + orderOffset);
+        arena = data + arenaOffset;
+
+        uint64_t offset = 0;
+        for (uint64_t t = 0; t < numTasks; ++t) {
+            Slot* slot = new (&slots[t]) Slot();
+            slot->state.store(PENDING);
+            slot->worker.store(-1);
+            slot->predictedSeconds = predictedSeconds[t];
+            slot->offset = offset;
+            slot->capacity = capacities[t];
+            offset += capacities[t];
+        }
+        return true;
+    }
+
+    void close() {
+        if (data != nullptr) munmap(data, mappedSize);
+        data = nullptr;
+        mappedSize = 0;
+    }
+
+    int size() const {
+        return numTasks;
+    }
+
+    // Tasks are claimed in this order, must not be called while workers run
+    void setOrder(const std::vector<int>& tasks) {
+        int64_t remaining = 0;
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            order[i] = tasks[i];
+            slots[tasks[i]].state.store(PENDING);
+            remaining += microseconds(slots[tasks[i]].predictedSeconds);
+        }
+        header->orderSize = tasks.size();
+        header->remainingMicroseconds.store(remaining);
+        header->next.store(0);
+    }
+
+    // Next task for worker, -1 if all are claimed. remainingPrediction is set to the predicted seconds of the tasks
+    // that were not claimed before, including this one.
+    int claim(int worker, double& remainingPrediction) {
+        uint64_t position = header->next.fetch_add(1);
+        if (position >= header->orderSize) return -1;
+        int task = order[position];
+        Slot& slot = slots[task];
+        slot.worker.store(worker);
+        slot.state.store(CLAIMED, std::memory_order_release);
+        remainingPrediction = header->remainingMicroseconds.fetch_sub(microseconds(slot.predictedSeconds)) / 1e6;
+        return task;
+    }
+
+    // False if the sequence does not fit into the range of the task
+    bool publish(int task, const std::string& sequence, int width, int remainingVertex) {
+        Slot& slot = slots[task];
+        if (sequence.size() > slot.capacity) return false;
+        std::memcpy(arena + slot.offset, sequence.data(), sequence.size());
+        slot.length = sequence.size();
+        slot.width = width;
+        slot.remainingVertex = remainingVertex;
+        slot.state.store(DONE, std::memory_order_release);
+        return true;
+    }
+
+    const Slot& slot(int task) const {
+        return slots[task];
+    }
+
+    bool done(int task) const {
+        return slots[task].state.load(std::memory_order_acquire) == DONE;
+    }
+
+    std::string sequence(int task) const {
+        return std::string(arena + slots[task].offset, slots[task].length);
+    }
+
+private:
+    struct Header {
+        std::atomic<uint64_t> next{0};
+        std::atomic<int64_t> remainingMicroseconds{0};
+        uint64_t orderSize = 0;
+    };
+
+    char* data = nullptr;
+    size_t mappedSize = 0;
+    uint64_t numTasks = 0;
+    Header* header = nullptr;
+    Slot* slots = nullptr;
+    int32_t* order = nullptr;
+    char* arena = nullptr;
+
+    static size_t align(size_t size) {
+        return (size + 63) / 64 * 64;
+    }
+
+    static int64_t microseconds(double seconds) {
+        return static_cast<int64_t>(std::llround(seconds * 1e6));
+    }
+};
+
+#endif // RESULTBOARD_HPP
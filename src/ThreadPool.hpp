@@ -0,0 +1,192 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+// Persistent worker threads for data-parallel loops. The calling thread takes part in every loop,
+// so a pool of size 1 has no workers and runs everything inline. A loop started while another one is
+// running (e.g. from inside func) runs inline as well.
+class ThreadPool {
+public:
+    explicit ThreadPool(int threads) {
+        for (int i = 1; i < threads; ++i) {
+            workers.emplace_back([this]() { work(); });
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&]() { return workerIds.size() == workers.size(); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) worker.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const {
+        return workers.size() + 1;
+    }
+
+    // Kernel thread ids of the workers, e.g. to attach per-thread counters
+    const std::vector<pid_t>& getWorkerIds() const {
+        return workerIds;
+    }
+
+    // Calls func(i) for every i in [0, count) and returns when all calls are finished.
+    // The order of the calls is not specified, func has to write its results to per-index slots.
+    void parallelFor(int count, const std::function<void(int)>& func) {
+        if (workers.empty() || count <= 1) {
+            for (int i = 0; i < count; ++i) func(i);
+            return;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (job != nullptr) {
+                lock.unlock();
+                for (int i = 0; i < count; ++i) func(i);
+                return;
+            }
+            job = &func;
+            jobSize = count;
+            next = 0;
+            finished = 0;
+            generation++;
+        }
+        wake.notify_all();
+
+        runJob(func, count);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&]() { return finished == count && active == 0; });
+        job = nullptr;
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::vector<pid_t> workerIds;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    const std::function<void(int)>* job = nullptr;
+    int jobSize = 0;
+    std::atomic<int> next{0};
+    int finished = 0;
+    int active = 0; // workers currently holding job
+    unsigned long generation = 0;
+    bool stopping = false;
+
+    void runJob(const std::function<void(int)>& func, int count) {
+        int processed = 0;
+        for (int i = next++; i < count; i = next++) {
+            func(i);
+            processed++;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        finished += processed;
+    }
+
+    void work() {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workerIds.push_back(syscall(SYS_gettid));
+        }
+        done.notify_all();
+
+        unsigned long seen = 0;
+        while (true) {
+            const std::function<void(int)>* func;
+            int count;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&]() { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                if (job == nullptr) continue;
+                func = job;
+                count = jobSize;
+                active++;
+            }
+
+            runJob(*func, count);
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                active--;
+            }
+            done.notify_all();
+        }
+    }
+};
+
+// One persistent thread that runs a single task at a time next to the calling thread, e.g. the lower bound of the
+// component that is being solved. A new task may only be started after wait() returned for the previous one.
+class BackgroundThread {
+public:
+    BackgroundThread() : thread([this]() { work(); }) {}
+
+    ~BackgroundThread() {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        thread.join();
+    }
+
+    BackgroundThread(const BackgroundThread&) = delete;
+    BackgroundThread& operator=(const BackgroundThread&) = delete;
+
+    void run(std::function<void()> func) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            task = std::move(func);
+            pending = true;
+        }
+        wake.notify_all();
+    }
+
+    // Returns when the last task is finished
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&]() { return !pending; });
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::function<void()> task;
+    bool pending = false;
+    bool stopping = false;
+    std::thread thread; // last member, the thread starts once the others are initialised
+
+    void work() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [&]() { return stopping || pending; });
+            if (stopping) return;
+            lock.unlock();
+            task();
+            lock.lock();
+            task = nullptr;
+            pending = false;
+            done.notify_all();
+        }
+    }
+};
+
+#endif // THREADPOOL_HPP
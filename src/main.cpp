@@ -10,16 +10,69 @@
 #include <chrono>
 #include <iomanip> 
 #include <cmath>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <unordered_map>
+#include <optional>
+#include <cstdint>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
 #include "BoostGraph.hpp"
+#include "LowerBound.hpp"
+#include "CacheCounters.hpp"
+#include "ThreadPool.hpp"
+#include "GraphCache.hpp"
+#include "AdjacencyPool.hpp"
+#include "MemoryUsage.hpp"
+#include "Checkpoint.hpp"
+#include "Reductions.hpp"
+#include "HeuristicSelection.hpp"
+#include "ResultBoard.hpp"
 
 using namespace std;
 using namespace std::chrono;
 
+// Compile with -DCOMPACT_MEMORY to keep all adjacency lists of a graph in one pooled 32-bit storage
+#ifdef COMPACT_MEMORY
+typedef AdjacencyPool AdjacencyLists;
+#else
+typedef vector<vector<int>> AdjacencyLists;
+#endif
+
 const int SCORE_RESET_THRESHOLD = 1;
 const int TIME_LIMIT = 500;  
+const long long BIPARTITE_BITSET_LIMIT = 1LL << 30; // max. |side1| * |side2| bits for bipartite neighbourhood bitsets
 
 bool connectedComponents = true;
 bool twinsElimination = false;
+bool bipartiteContraction = false; // contract only same-side pairs on bipartite components
+bool memoryReport = true;    // report the peak RSS of reading and solving
+bool cacheTelemetry = false; // report hardware cache and TLB misses of every heuristic run
+
+int scoringThreads = 0;        // threads scoring the candidate pairs of one step, 0 = all hardware threads
+bool scaleCandidates = false;  // start from more low degree vertices when more scoring threads are available
+const int PARALLEL_SCORING_MIN_VERTICES = 1000; // smaller graphs are scored serially
+
+enum VertexOrdering { ORIGINAL, RCM, DEGREE_SORTED };
+VertexOrdering vertexOrdering = ORIGINAL; // renumbering of component vertices for memory locality
+bool lowerBounds = true; // compute a lower bound per component in a background thread to stop restarts and refinement
+bool restarts = false;   // rerun the random walk heuristic with new seeds until the lower bound or TIME_LIMIT is reached
+double checkpointInterval = 60; // min. seconds between two checkpoints of a heuristic run (--checkpoint)
+bool reductionRules = true; // contract trees and pendant twins before the heuristics
+bool pathReduction = false; // also shrink long induced paths, this costs width 2
+const double REDUCTION_MIN_SHARE = 0.05; // a kernel that removes less of the component is checked against the whole component
+bool refinement = false; // recompute the sequence from shortly before the step that reached the width
+const int REFINEMENT_WINDOWS = 6; // windows start 4, 16, 64, ... steps before that step
+const int REFINEMENT_SEEDS = 4;   // attempts per window, the first one uses the degree heuristic
+bool engineSelection = true; // choose each component's heuristic and time share with the cost model, not by degree deviation
+CostModel costModel; // coefficients of the cost model, replaced by --cost-model
+const double SELECTION_MARGIN = 0.5; // predicted width the cost model has to gain to override the degree deviation rule
+const int SELECTION_MIN_VERTICES = 20; // smaller components use the rule, the calibration (--min-vertices) does not cover them
+bool alternativeEngines = true; // also run the other modelled engine if the time share allows it and keep the better sequence
+Engine forcedEngine = ENGINE_COUNT; // --engine runs this heuristic on every component (for calibration)
+int workers = 1; // processes solving components in parallel over a shared graph cache, also set by --workers
 
 struct PairHash {
     template <class T1, class T2>
@@ -30,6 +83,23 @@ struct PairHash {
     }
 };
 
+// Persistent pool shared by all heuristic runs, created on first use
+ThreadPool& getScoringPool() {
+    static ThreadPool pool(scoringThreads > 0 ? scoringThreads : std::max(1u, std::thread::hardware_concurrency()));
+    return pool;
+}
+
+// Thread that computes the lower bound of the component being solved, created on first use
+BackgroundThread& getLowerBoundThread() {
+    static BackgroundThread thread;
+    return thread;
+}
+
+struct TwinClasses {
+    vector<vector<int>> trueTwins;
+    vector<vector<int>> falseTwins;
+};
+
 struct ContractionStep {
     int iteration;
     pair<int, int> vertexPair;
@@ -68,13 +138,14 @@ class Graph {
 private:
     vector<int> vertices;
     vector<int> ids; // mapping id -> index, used for connected components
-    vector<vector<int>> adjListBlack;  // For black edges
-    vector<vector<int>> adjListRed;    // For red edges
+    AdjacencyLists adjListBlack;  // For black edges
+    AdjacencyLists adjListRed;    // For red edges
     vector<vector<int>> redDegreeToVertices; // vertex id saved
     vector<vector<int>> degreeToVertices;
     int width = 0;
     std::mt19937 gen;
     bool useFixedSeed = true;
+    bool logSteps = true; // print every contraction step of the heuristics
 
 public:
     Graph() {
@@ -103,6 +174,11 @@ public:
         }
     }
 
+    // Moves let components and finished graphs hand over their memory instead of copying it
+    Graph(Graph&& g) = default;
+    Graph& operator=(Graph&& g) = default;
+    Graph& operator=(const Graph& g) = default;
+
     int getRealScoreSimulate();
 
     void updateDegrees(int v){
@@ -226,54 +302,228 @@ public:
         return this->ids;
     }
 
-    bool isBipartiteBoost(std::vector<int>& partition1, std::vector<int>& partition2) {
-        BoostGraph boostGraph(vertices.size());
-        for (int i = 0; i < adjListBlack.size(); ++i) {
-            for (int j = 0; j < adjListBlack[i].size(); ++j) {
-                if (i < adjListBlack[i][j])  boostGraph.addEdge(i, adjListBlack[i][j]);
+    bool hasRedEdges() const {
+        for (size_t i = 0; i < adjListRed.size(); ++i) {
+            if (!adjListRed[i].empty()) return true;
+        }
+        return false;
+    }
+
+    // Black adjacency of the remaining vertices, indexed by their position in getVertices()
+    vector<vector<int>> getRemainingAdjacency() const {
+        vector<int> position(adjListBlack.size(), -1);
+        for (size_t i = 0; i < vertices.size(); ++i) position[vertices[i]] = i;
+        vector<vector<int>> adjacency(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            for (int u : adjListBlack[vertices[i]]) adjacency[i].push_back(position[u]);
+        }
+        return adjacency;
+    }
+
+    // Kernel left by the reduction rules applied to getRemainingAdjacency(), with the original ids
+    Graph kernelGraph(const Reductions& reductions) const {
+        vector<int> kernel = reductions.getKernel();
+        vector<int> localIndex(vertices.size(), -1);
+        vector<int> kernelVertices(kernel.size());
+        for (size_t i = 0; i < kernel.size(); ++i) {
+            localIndex[kernel[i]] = i;
+            kernelVertices[i] = vertices[kernel[i]];
+        }
+
+        Graph g;
+        g.addVertices(kernel.size(), mapIds(kernelVertices));
+        for (size_t i = 0; i < kernel.size(); ++i) {
+            for (int u : reductions.getBlackNeighbors(kernel[i])) g.addEdgeBegin(i, localIndex[u]);
+        }
+        g.updateBlackDegrees();
+        for (int i = 0; i < static_cast<int>(kernel.size()); ++i) {
+            for (int u : reductions.getRedNeighbors(kernel[i])) {
+                if (i < localIndex[u]) g.addEdge(i, localIndex[u], "red");
             }
         }
+        g.updateWidth();
+        return g;
+    }
+
+    vector<vector<int>> getBlackAdjacency() const {
+        vector<vector<int>> adjacency(adjListBlack.size());
+        for (int i = 0; i < adjListBlack.size(); ++i) {
+            adjacency[i].assign(adjListBlack[i].begin(), adjListBlack[i].end());
+        }
+        return adjacency;
+    }
 
-        return boostGraph.isBipartite(partition1, partition2);
+    void setSeed(unsigned int seed) {
+        gen.seed(seed);
     }
 
-    std::vector<Graph> findConnectedComponentsBoost() {
-        BoostGraph boostGraph(vertices.size());
+    void setLogSteps(bool value) {
+        logSteps = value;
+    }
+
+    // Contraction state for checkpoints. The order inside the degree buckets decides ties, so they are stored as they are.
+    void saveState(Checkpoint::Writer& writer) const {
+        writer.putList(vertices);
+        writer.putList(ids);
+        writer.put<uint64_t>(adjListBlack.size());
         for (int i = 0; i < adjListBlack.size(); ++i) {
+            writer.putList(adjListBlack[i]);
+            writer.putList(adjListRed[i]);
+        }
+        writer.put<uint64_t>(redDegreeToVertices.size());
+        for (const vector<int>& bucket : redDegreeToVertices) writer.putList(bucket);
+        writer.put<uint64_t>(degreeToVertices.size());
+        for (const vector<int>& bucket : degreeToVertices) writer.putList(bucket);
+        writer.put(width);
+        ostringstream rng;
+        rng << gen;
+        writer.putString(rng.str());
+    }
+
+    bool loadState(Checkpoint::Reader& reader) {
+        vertices = reader.getVector<int>();
+        ids = reader.getVector<int>();
+        uint64_t n = reader.get<uint64_t>();
+        if (!reader.ok() || n != ids.size()) return false;
+        adjListBlack = AdjacencyLists();
+        adjListRed = AdjacencyLists();
+        adjListBlack.resize(n);
+        adjListRed.resize(n);
+        for (uint64_t i = 0; i < n; ++i) {
+            assignList(adjListBlack[i], reader.getVector<int>());
+            assignList(adjListRed[i], reader.getVector<int>());
+        }
+        redDegreeToVertices.assign(reader.get<uint64_t>(), vector<int>());
+        for (vector<int>& bucket : redDegreeToVertices) bucket = reader.getVector<int>();
+        degreeToVertices.assign(reader.get<uint64_t>(), vector<int>());
+        for (vector<int>& bucket : degreeToVertices) bucket = reader.getVector<int>();
+        width = reader.get<int>();
+        istringstream rng(reader.getString());
+        rng >> gen;
+        return reader.ok() && !rng.fail();
+    }
+
+    bool isBipartiteBoost(std::vector<int>& partition1, std::vector<int>& partition2) {
+        BoostGraph boostGraph(adjListBlack.size());
+        for (int i = 0; i < static_cast<int>(adjListBlack.size()); ++i) {
             for (int j = 0; j < adjListBlack[i].size(); ++j) {
-                boostGraph.addEdge(i, adjListBlack[i][j]);
+                if (i < adjListBlack[i][j])  boostGraph.addEdge(i, adjListBlack[i][j]);
             }
         }
 
-        vector<set<pair<int, int>>> components;
-        vector<vector<int>> vertices;
-        std::tie(components, vertices) = boostGraph.getConnectedComponentAndVertices();  // Call getConnectedComponents and unpack the result
+        // Red edges only appear after contractions (e.g. twins elimination), they break the side structure
+        for (size_t i = 0; i < adjListRed.size(); ++i) {
+            if (!adjListRed[i].empty()) return false;
+        }
+
+        if (!boostGraph.isBipartite(partition1, partition2)) return false;
+
+        // Vertices already removed by twins elimination are still part of the boost graph
+        vector<bool> present(adjListBlack.size(), false);
+        for (int v : vertices) present[v] = true;
+        auto removed = [&present](int v) { return !present[v]; };
+        partition1.erase(std::remove_if(partition1.begin(), partition1.end(), removed), partition1.end());
+        partition2.erase(std::remove_if(partition2.begin(), partition2.end(), removed), partition2.end());
+        return true;
+    }
+
+    // A connected graph is moved into the result instead of copied, the graph must not be used afterwards
+    std::vector<Graph> findConnectedComponentsBoost() {
+        vector<vector<int>> vertices = findComponentVertices();
         std::vector<Graph> result;
-        if (components.size() == 1) {
-            result.push_back(*this);
+        if (vertices.size() == 1 && vertexOrdering == ORIGINAL) {
+            result.push_back(std::move(*this));
             return result;
         }
 
-        for (int i = 0; i < components.size(); ++i) {
+        vector<int> localIndex(adjListBlack.size(), -1);
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            vector<int> order = orderVertices(vertices[i]);
+            for (size_t j = 0; j < order.size(); ++j) localIndex[order[j]] = j;
+
             Graph g;
-            g.addVertices(vertices[i].size(), vertices[i]);
-            constructFromEdges(g, components[i]);
+            g.addVertices(order.size(), mapIds(order));
+            for (size_t j = 0; j < order.size(); ++j) g.adjListBlack[j].reserve(adjListBlack[order[j]].size());
+            for (int v : order) {
+                for (int u : adjListBlack[v]) {
+                    if (localIndex[v] < localIndex[u]) g.addEdgeBegin(localIndex[v], localIndex[u]);
+                }
+            }
             g.updateBlackDegrees();
             result.push_back(g);
         }
-        for (const auto& edges : components) {
+        return result;
+    }
+
+    // Sorted vertex lists of the connected components. The boost graph needs several times the memory of the
+    // adjacency lists, the compact build labels the components with a BFS on adjListBlack instead.
+    vector<vector<int>> findComponentVertices() const {
+#ifdef COMPACT_MEMORY
+        vector<int> component(adjListBlack.size(), -1);
+        vector<vector<int>> result;
+        for (int start = 0; start < adjListBlack.size(); ++start) {
+            if (component[start] != -1) continue;
+            vector<int> members = {start};
+            component[start] = result.size();
+            for (size_t head = 0; head < members.size(); ++head) {
+                for (int u : adjListBlack[members[head]]) {
+                    if (component[u] == -1) {
+                        component[u] = result.size();
+                        members.push_back(u);
+                    }
+                }
+            }
+            std::sort(members.begin(), members.end());
+            result.push_back(std::move(members));
         }
         return result;
+#else
+        BoostGraph boostGraph(vertices.size());
+        for (int i = 0; i < static_cast<int>(adjListBlack.size()); ++i) {
+            for (int j = 0; j < adjListBlack[i].size(); ++j) {
+                if (i < adjListBlack[i][j]) boostGraph.addEdge(i, adjListBlack[i][j]);
+            }
+        }
+        return boostGraph.getComponentVertices();
+#endif
     }
 
-    static void constructFromEdges(Graph& g, const std::set<std::pair<int, int>>& edges) {
-        for (const auto& edge : edges) {
-            int u = edge.first, v = edge.second;
-            vector<int> ids = g.getIds();
-            int vId = std::distance(ids.begin(), std::find(ids.begin(), ids.end(), v)); 
-            int uId = std::distance(ids.begin(), std::find(ids.begin(), ids.end(), u)); 
-            g.addEdgeBegin(vId, uId);
+    // Orders the vertices of one component for memory locality, vertices that are close in the graph get close indices
+    vector<int> orderVertices(const vector<int>& component) const {
+        vector<int> order = component;
+        auto degree = [this](int v) { return adjListBlack[v].size(); };
+        if (vertexOrdering == DEGREE_SORTED) {
+            std::stable_sort(order.begin(), order.end(), [&degree](int a, int b) { return degree(a) > degree(b); });
+        }
+        else if (vertexOrdering == RCM) {
+            // Reverse Cuthill-McKee: BFS from a minimum degree vertex, neighbours in increasing degree order
+            order.clear();
+            vector<bool> visited(adjListBlack.size(), false);
+            int startVertex = *std::min_element(component.begin(), component.end(), [&degree](int a, int b) { return degree(a) < degree(b); });
+            order.push_back(startVertex);
+            visited[startVertex] = true;
+            for (size_t head = 0; head < order.size(); ++head) {
+                vector<int> neighbors;
+                for (int u : adjListBlack[order[head]]) {
+                    if (!visited[u]) {
+                        visited[u] = true;
+                        neighbors.push_back(u);
+                    }
+                }
+                std::stable_sort(neighbors.begin(), neighbors.end(), [&degree](int a, int b) { return degree(a) < degree(b); });
+                order.insert(order.end(), neighbors.begin(), neighbors.end());
+            }
+            std::reverse(order.begin(), order.end());
         }
+        return order;
+    }
+
+    // Translates vertex indices of this graph to the original ids
+    vector<int> mapIds(const vector<int>& indices) const {
+        if (ids.empty()) return indices;
+        vector<int> result(indices.size());
+        for (size_t i = 0; i < indices.size(); ++i) result[i] = ids[indices[i]];
+        return result;
     }
 
     float getDegreeDeviation() {
@@ -293,6 +543,75 @@ public:
         return averageDegreeDeviation;
     }
 
+    // Degrees count black and red edges. Twins are found by hashing neighbourhoods as sums of random vertex keys,
+    // a collision only makes the twin ratio slightly too high.
+    ComponentFeatures getFeatures(bool bipartite) const {
+        ComponentFeatures features;
+        features.vertices = vertices.size();
+        features.bipartite = bipartite;
+        if (vertices.empty()) return features;
+
+        std::mt19937_64 keyGenerator(adjListBlack.size());
+        vector<uint64_t> key(adjListBlack.size());
+        for (uint64_t& k : key) k = keyGenerator();
+
+        vector<int> degrees;
+        degrees.reserve(vertices.size());
+        unordered_map<uint64_t, int> openCount, closedCount;
+        vector<uint64_t> openHash(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            int v = vertices[i];
+            for (int u : adjListBlack[v]) openHash[i] += key[u];
+            for (int u : adjListRed[v]) openHash[i] += key[u];
+            degrees.push_back(adjListBlack[v].size() + adjListRed[v].size());
+            openCount[openHash[i]]++;
+            closedCount[openHash[i] + key[v]]++;
+        }
+
+        long long degreeSum = 0;
+        int twins = 0;
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            degreeSum += degrees[i];
+            features.maxDegree = max(features.maxDegree, degrees[i]);
+            if (openCount[openHash[i]] > 1 || closedCount[openHash[i] + key[vertices[i]]] > 1) twins++;
+        }
+        features.edges = degreeSum / 2;
+        features.meanDegree = static_cast<double>(degreeSum) / vertices.size();
+        double deviation = 0;
+        for (int degree : degrees) deviation += std::abs(degree - features.meanDegree);
+        features.degreeDeviation = deviation / vertices.size();
+        features.twinRatio = static_cast<double>(twins) / vertices.size();
+
+        // Random paths a - v - b, closed if a and b are adjacent. Local graphs (grids with diagonals, geometric graphs)
+        // have many closed ones, random graphs almost none.
+        vector<int> centers;
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            if (degrees[i] >= 2) centers.push_back(vertices[i]);
+        }
+        if (!centers.empty()) {
+            auto neighbor = [this](int v, size_t k) {
+                return k < adjListBlack[v].size() ? adjListBlack[v][k] : adjListRed[v][k - adjListBlack[v].size()];
+            };
+            auto adjacent = [this](int a, int b) {
+                if (adjListBlack[a].size() + adjListRed[a].size() > adjListBlack[b].size() + adjListRed[b].size()) std::swap(a, b);
+                return std::find(adjListBlack[a].begin(), adjListBlack[a].end(), b) != adjListBlack[a].end()
+                       || std::find(adjListRed[a].begin(), adjListRed[a].end(), b) != adjListRed[a].end();
+            };
+            int samples = min<long long>(ComponentFeatures::CLUSTERING_SAMPLES,
+                                         static_cast<long long>(ComponentFeatures::CLUSTERING_SAMPLES_PER_VERTEX) * vertices.size());
+            int closed = 0;
+            for (int sample = 0; sample < samples; ++sample) {
+                int v = centers[keyGenerator() % centers.size()];
+                size_t degree = adjListBlack[v].size() + adjListRed[v].size();
+                size_t first = keyGenerator() % degree;
+                size_t second = (first + 1 + keyGenerator() % (degree - 1)) % degree;
+                if (adjacent(neighbor(v, first), neighbor(v, second))) closed++;
+            }
+            features.clustering = static_cast<double>(closed) / samples;
+        }
+        return features;
+    }
+
     void updateVertexRedDegree(int vertex, int diff) {
         int oldDegree = adjListRed[vertex].size();
         int newDegree = oldDegree + diff;
@@ -478,8 +797,11 @@ public:
     }
 
     ostringstream findTwins(bool trueTwins) {
-        ostringstream contractionSequence;        
-        
+        return contractTwins(findTwinClasses());
+    }
+
+    // Partitions the vertices into classes with equal open (trueTwins) and closed (falseTwins) neighbourhoods
+    TwinClasses findTwinClasses() {
         vector<vector<int>> true_partitions; 
         vector<vector<int>> updated_true_partitions; 
         true_partitions.push_back(vertices);
@@ -526,7 +848,21 @@ public:
 
         }
 
-        for (const vector<int>& partition : true_partitions) {
+        TwinClasses classes;
+        for (vector<int>& partition : true_partitions) {
+            if (partition.size() > 1) classes.trueTwins.push_back(std::move(partition));
+        }
+        for (vector<int>& partition : false_partitions) {
+            if (partition.size() > 1) classes.falseTwins.push_back(std::move(partition));
+        }
+        return classes;
+    }
+
+    // Contracts every twin class into its first vertex
+    ostringstream contractTwins(const TwinClasses& classes) {
+        ostringstream contractionSequence;
+
+        for (const vector<int>& partition : classes.trueTwins) {
             if (partition.size() > 1) {
                 auto it = partition.begin();
                 int first = *it;
@@ -541,7 +877,7 @@ public:
             }
         }
 
-        for (const vector<int>& partition : false_partitions) {
+        for (const vector<int>& partition : classes.falseTwins) {
             if (partition.size() > 1) {
                 auto it = partition.begin();
                 int first = *it;
@@ -559,20 +895,69 @@ public:
     }
 
 
-    ostringstream findRedDegreeContractionRandomWalk(){ 
+    // Number of low degree vertices the heuristics start from, grows with the scoring threads if scaleCandidates is set
+    int candidateVertexCount() {
+        if (!scaleCandidates) return 20;
+        return static_cast<int>(20 * std::sqrt(getScoringPool().size()));
+    }
+
+    // Returns the first candidate pair with the lowest score. Scores that are not cached yet are computed on the
+    // scoring pool, the reduction runs in candidate order so the result does not depend on the number of threads.
+    pair<int, int> findBestPair(const vector<pair<int, int>>& candidates, vector<vector<pair<int, int>>>& scores) {
+        vector<int> candidateScores(candidates.size(), INT_MAX);
+        vector<int> pending;
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            int v1 = candidates[i].first, v2 = candidates[i].second;
+            auto it = find_if(scores[v1].begin(), scores[v1].end(),
+                            [v2](const pair<int, int>& p){ return p.first == v2; });
+            if (it == scores[v1].end()) {
+                scores[v1].push_back({v2, -1});
+                pending.push_back(i);
+            }
+            else if (it->second >= 0) {
+                candidateScores[i] = it->second;
+            }
+            // else: repeated candidate of this step, its first occurrence wins the reduction anyway
+        }
+
+        auto scorePending = [&](int k) {
+            const pair<int, int>& candidate = candidates[pending[k]];
+            candidateScores[pending[k]] = getScore(candidate.first, candidate.second);
+        };
+        if (vertices.size() >= PARALLEL_SCORING_MIN_VERTICES) getScoringPool().parallelFor(pending.size(), scorePending);
+        else for (size_t k = 0; k < pending.size(); ++k) scorePending(k);
+
+        for (int i : pending) {
+            int v1 = candidates[i].first, v2 = candidates[i].second;
+            find_if(scores[v1].begin(), scores[v1].end(), [v2](const pair<int, int>& p){ return p.first == v2; })->second = candidateScores[i];
+        }
+
+        int bestScore = INT_MAX;
+        pair<int, int> bestPair;
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            if (candidateScores[i] < bestScore) {
+                bestScore = candidateScores[i];
+                bestPair = candidates[i];
+            }
+        }
+        return bestPair;
+    }
+
+    // Both heuristics give up as soon as the width reaches cutoffWidth or the deadline has passed, the partial sequence
+    // is returned. With a checkpoint the state is saved after a score reset whenever checkpoint->due() allows it.
+    ostringstream findRedDegreeContractionRandomWalk(int cutoffWidth = INT_MAX, Checkpoint* checkpoint = nullptr,
+                                                     high_resolution_clock::time_point deadline = high_resolution_clock::time_point::max()){ 
         ostringstream contractionSequence;
         vector<vector<pair<int, int>>> scores(*max_element(vertices.begin(), vertices.end()) + 1); // because of twin rule
         auto heuristic_start_time = high_resolution_clock::now();
         
         int iterationCounter = 0;
-        while (vertices.size() > 1) {
+        while (vertices.size() > 1 && width < cutoffWidth && high_resolution_clock::now() < deadline) {
             auto start = high_resolution_clock::now();
 
-            vector<int> lowestDegreeVertices = getTopNVerticesWithLowestRedDegree(20);
-
-            int bestScore = INT_MAX;
-            pair<int, int> bestPair;
+            vector<int> lowestDegreeVertices = getTopNVerticesWithLowestRedDegree(candidateVertexCount());
 
+            vector<pair<int, int>> candidates;
             for (int i = 0; i < lowestDegreeVertices.size(); i++) {
                 int v1 = lowestDegreeVertices[i];
                 set<int> randomWalkVertices = getRandomWalkVertices(v1, 10);  
@@ -581,24 +966,10 @@ public:
                     if (v2 > v1) {
                         std::swap(v1, v2);
                     }
-
-                    auto it = find_if(scores[v1].begin(), scores[v1].end(),
-                                    [v2](const pair<int, int>& p){ return p.first == v2; });
-                    int score;
-                    if (it != scores[v1].end()) {
-                        score = it->second;
-                    }
-                    else {
-                        score = getScore(v1, v2);
-                        scores[v1].push_back({v2, score});
-                    }
-                    
-                    if (score < bestScore) {
-                        bestScore = score;
-                        bestPair = {v1, v2};
-                    }
+                    candidates.push_back({v1, v2});
                 }
             }
+            pair<int, int> bestPair = findBestPair(candidates, scores);
 
             contractionSequence << getVertexId(bestPair.first) + 1 << " " << getVertexId(bestPair.second) + 1 << "\n";
 
@@ -608,7 +979,7 @@ public:
             auto duration = duration_cast<milliseconds>(stop - start);
             int seconds_part = duration.count() / 1000;
             int milliseconds_part = duration.count() % 1000;
-            std::cout << "c (Left " << vertices.size() << ", tww: " << getWidth() << ") Cycle in " << seconds_part << "." 
+            if (logSteps) std::cout << "c (Left " << vertices.size() << ", tww: " << getWidth() << ") Cycle in " << seconds_part << "." 
             << std::setfill('0') << std::setw(9) << milliseconds_part 
             << " seconds" << std::endl;
 
@@ -617,26 +988,26 @@ public:
                     scores[i].clear();
                 }
                 iterationCounter = 0;
-                cout << "c Reset at " << vertices.size() << endl;
+                if (logSteps) cout << "c Reset at " << vertices.size() << endl;
+                saveCheckpoint(checkpoint, contractionSequence);
             }
         }
         return contractionSequence;
     }
 
-    ostringstream findDegreeContraction(){ 
+    ostringstream findDegreeContraction(int cutoffWidth = INT_MAX, Checkpoint* checkpoint = nullptr,
+                                        high_resolution_clock::time_point deadline = high_resolution_clock::time_point::max()){ 
         ostringstream contractionSequence;
         vector<vector<pair<int, int>>> scores(*max_element(vertices.begin(), vertices.end()) + 1); // because of twin rule
         auto heuristic_start_time = high_resolution_clock::now();
         
         int iterationCounter = 0;
-        while (vertices.size() > 1) {
+        while (vertices.size() > 1 && width < cutoffWidth && high_resolution_clock::now() < deadline) {
             auto start = high_resolution_clock::now();
 
-            vector<int> lowestDegreeVertices = getTopNVerticesWithLowestDegree(20);
+            vector<int> lowestDegreeVertices = getTopNVerticesWithLowestDegree(candidateVertexCount());
             
-            int bestScore = INT_MAX;
-            pair<int, int> bestPair;
-
+            vector<pair<int, int>> candidates;
             for (int i = 0; i < lowestDegreeVertices.size(); i++) {
                 for (int j = i+1; j < lowestDegreeVertices.size(); j++) {
                     int v1 = lowestDegreeVertices[i];
@@ -645,24 +1016,10 @@ public:
                     if (v2 > v1) {
                         std::swap(v1, v2);
                     }
-
-                    auto it = find_if(scores[v1].begin(), scores[v1].end(),
-                                    [v2](const pair<int, int>& p){ return p.first == v2; });
-                    int score;
-                    if (it != scores[v1].end()) {
-                        score = it->second;
-                    }
-                    else {
-                        score = getScore(v1, v2);
-                        scores[v1].push_back({v2, score});
-                    }
-                    
-                    if (score < bestScore) {
-                        bestScore = score;
-                        bestPair = {v1, v2};
-                    }
+                    candidates.push_back({v1, v2});
                 }
             }
+            pair<int, int> bestPair = findBestPair(candidates, scores);
 
             contractionSequence << getVertexId(bestPair.first) + 1 << " " << getVertexId(bestPair.second) + 1 << "\n";
             mergeVertices(bestPair.first, bestPair.second);
@@ -673,21 +1030,152 @@ public:
                     scores[i].clear();
                 }
                 iterationCounter = 0;
-                cout << "c Reset at " << vertices.size() << endl;
+                if (logSteps) cout << "c Reset at " << vertices.size() << endl;
+                saveCheckpoint(checkpoint, contractionSequence);
             }
 
             auto stop = high_resolution_clock::now();
             auto duration = duration_cast<milliseconds>(stop - start);
             int seconds_part = duration.count() / 1000;
             int milliseconds_part = duration.count() % 1000;
-            std::cout << "c (Merged ( " << getVertexId(bestPair.first) << "," << getVertexId(bestPair.second) << "), left " << vertices.size() << ", tww: " << getWidth() << ") Cycle in " << seconds_part << "." 
+            if (logSteps) std::cout << "c (Merged ( " << getVertexId(bestPair.first) << "," << getVertexId(bestPair.second) << "), left " << vertices.size() << ", tww: " << getWidth() << ") Cycle in " << seconds_part << "." 
             << std::setfill('0') << std::setw(9) << milliseconds_part 
             << " seconds" << std::endl;
         }
         return contractionSequence;
     }
 
+    // Bipartite variant of the random walk heuristic: only pairs from the same side are scored and contracted, on equal
+    // scores the sides take turns. Random walks of length 2 stay on the side of the start vertex. Neighbourhoods are kept as bitsets over
+    // the opposite side if they fit into BIPARTITE_BITSET_LIMIT bits, otherwise getScore is used.
+    // A run resumed from a checkpoint passes the side of its last contraction as lastSide.
+    ostringstream findBipartiteContraction(const vector<int>& side1, const vector<int>& side2, int cutoffWidth = INT_MAX,
+                                           Checkpoint* checkpoint = nullptr, int lastSide = 1,
+                                           high_resolution_clock::time_point deadline = high_resolution_clock::time_point::max()){
+        ostringstream contractionSequence;
+        const vector<int>* sides[2] = {&side1, &side2};
+        vector<int> side(adjListBlack.size(), -1);
+        vector<int> sideIndex(adjListBlack.size(), -1);
+        int sideCount[2] = {(int)side1.size(), (int)side2.size()};
+        for (int s = 0; s < 2; ++s) {
+            for (size_t i = 0; i < sides[s]->size(); ++i) {
+                side[(*sides[s])[i]] = s;
+                sideIndex[(*sides[s])[i]] = i;
+            }
+        }
+
+        // neighborhoodBits[s][i] is the neighbourhood of the i-th vertex of side s over the other side
+        bool useBitsets = (long long)side1.size() * side2.size() <= BIPARTITE_BITSET_LIMIT;
+        vector<vector<uint64_t>> neighborhoodBits[2];
+        if (useBitsets) {
+            for (int s = 0; s < 2; ++s) {
+                int words = (sideCount[1 - s] + 63) / 64;
+                neighborhoodBits[s].assign(sideCount[s], vector<uint64_t>(words, 0));
+                for (int v : vertices) {
+                    if (side[v] != s) continue;
+                    for (int u : adjListBlack[v]) neighborhoodBits[s][sideIndex[v]][sideIndex[u] / 64] |= 1ULL << (sideIndex[u] % 64);
+                    for (int u : adjListRed[v]) neighborhoodBits[s][sideIndex[v]][sideIndex[u] / 64] |= 1ULL << (sideIndex[u] % 64);
+                }
+            }
+        }
+
+        // A resumed run has already contracted some vertices of both sides
+        sideCount[0] = std::count_if(vertices.begin(), vertices.end(), [&side](int v) { return side[v] == 0; });
+        sideCount[1] = vertices.size() - sideCount[0];
+
+        auto score = [&](int v1, int v2) {
+            if (!useBitsets) return getScore(v1, v2);
+            const vector<uint64_t>& a = neighborhoodBits[side[v1]][sideIndex[v1]];
+            const vector<uint64_t>& b = neighborhoodBits[side[v2]][sideIndex[v2]];
+            int count = 0;
+            for (size_t w = 0; w < a.size(); ++w) count += __builtin_popcountll(a[w] ^ b[w]);
+            return count;
+        };
+
+        while (vertices.size() > 1 && width < cutoffWidth && high_resolution_clock::now() < deadline) {
+            pair<int, int> bestPair;
+            if (sideCount[0] < 2 && sideCount[1] < 2) {
+                // One vertex per side left
+                bestPair = {vertices[0], vertices[1]};
+            }
+            else {
+                vector<int> lowestDegreeVertices = getTopNVerticesWithLowestRedDegree(candidateVertexCount());
+
+                // Ties go to the side that was not contracted last, so both sides shrink in turns
+                int bestScore = INT_MAX;
+                bool bestOnLastSide = true;
+                for (int v1 : lowestDegreeVertices) {
+                    if (sideCount[side[v1]] < 2) continue;
+                    set<int> walkVertices;
+                    for (int i = 0; i < 10; ++i) walkVertices.insert(getRandomNeighbor(getRandomNeighbor(v1)));
+                    walkVertices.erase(v1);
+
+                    bool onLastSide = side[v1] == lastSide;
+                    for (int v2 : walkVertices) {
+                        int currentScore = score(v1, v2);
+                        if (currentScore < bestScore || (currentScore == bestScore && bestOnLastSide && !onLastSide)) {
+                            bestScore = currentScore;
+                            bestOnLastSide = onLastSide;
+                            bestPair = {max(v1, v2), min(v1, v2)};
+                        }
+                    }
+                }
+
+                if (bestScore == INT_MAX) {
+                    // No walk found a partner, fall back to any two vertices of a side with at least two vertices
+                    int s = sideCount[0] >= 2 ? 0 : 1;
+                    vector<int> sameSide;
+                    for (int v : vertices) {
+                        if (side[v] == s) sameSide.push_back(v);
+                        if (sameSide.size() == 2) break;
+                    }
+                    bestPair = {max(sameSide[0], sameSide[1]), min(sameSide[0], sameSide[1])};
+                }
+            }
+
+            int source = bestPair.first, twin = bestPair.second;
+            if (useBitsets && side[source] == side[twin]) {
+                int s = side[source];
+                vector<uint64_t>& sourceBits = neighborhoodBits[s][sideIndex[source]];
+                const vector<uint64_t>& twinBits = neighborhoodBits[s][sideIndex[twin]];
+                for (size_t w = 0; w < sourceBits.size(); ++w) sourceBits[w] |= twinBits[w];
+                auto moveToSource = [&](int u) {
+                    vector<uint64_t>& bits = neighborhoodBits[1 - s][sideIndex[u]];
+                    bits[sideIndex[twin] / 64] &= ~(1ULL << (sideIndex[twin] % 64));
+                    bits[sideIndex[source] / 64] |= 1ULL << (sideIndex[source] % 64);
+                };
+                for (int u : adjListBlack[twin]) moveToSource(u);
+                for (int u : adjListRed[twin]) moveToSource(u);
+            }
+
+            contractionSequence << getVertexId(source) + 1 << " " << getVertexId(twin) + 1 << "\n";
+            mergeVertices(source, twin);
+            sideCount[side[twin]]--;
+            lastSide = side[twin];
+            saveCheckpoint(checkpoint, contractionSequence, lastSide);
+        }
+        return contractionSequence;
+    }
+
 private:
+    // extra is engine specific state that is stored after the graph, -1 if there is none
+    void saveCheckpoint(Checkpoint* checkpoint, const ostringstream& sequence, int extra = -1) const {
+        if (checkpoint == nullptr || !checkpoint->due()) return;
+        bool saved = checkpoint->saveSequence(sequence.str(), [&]() {
+            Checkpoint::Writer writer;
+            saveState(writer);
+            writer.put(extra);
+            return writer.str();
+        });
+        if (!saved) cout << "c Could not write checkpoint" << endl;
+    }
+
+    template <class List>
+    static void assignList(List&& list, const vector<int>& values) {
+        list.reserve(values.size());
+        for (int v : values) list.push_back(v);
+    }
+
     void updateWidth() {
         for (int i = redDegreeToVertices.size() - 1; i >= 0; i--) {
             if (!redDegreeToVertices[i].empty()) {
@@ -699,8 +1187,8 @@ private:
 
     int getUpdatedWidth() {
         int updatedWidth = 0;
-        for (const auto& innerVector : adjListRed) {
-            updatedWidth = max(updatedWidth, static_cast<int>(innerVector.size()));
+        for (size_t i = 0; i < adjListRed.size(); ++i) {
+            updatedWidth = max(updatedWidth, static_cast<int>(adjListRed[i].size()));
         }
         return updatedWidth;
     }
@@ -716,19 +1204,609 @@ string getLastLine(ostringstream& oss) {
     }
 }
 
-int main() {
+// Heuristic run of a component that was interrupted, restored from a checkpoint
+struct ResumedRun {
+    string state;    // Graph::saveState of the run and the engine specific state
+    string sequence; // contractions of the run up to the checkpoint
+    Engine engine = ENGINE_COUNT; // engine the run was started with
+};
+
+// Local search on a finished sequence. The width is reached for the first time at a single step, only the contractions
+// up to that step can avoid it. Every window replays the sequence up to 4, 16, 64, ... steps before that step from a
+// snapshot and recomputes the rest with the degree heuristic and the random walk with new seeds, stopping as soon as
+// the width is reached again. All windows and seeds of a round run in parallel on the scoring pool. Rounds continue
+// on the improved sequence until no attempt improves, the width matches the lower bound or the deadline is reached.
+// Only windows that are expected to be recomputed before the deadline are tried, at secondsPerStep of the first run,
+// and attempts still running at the deadline are abandoned.
+void refineSolution(Graph& c, const Graph& initial, ComponentSolution& best, const LowerBound& lowerBound,
+                    std::atomic<int>& upperBound, const high_resolution_clock::time_point& deadline, double secondsPerStep) {
+    auto timeLeft = [&deadline]() {
+        return high_resolution_clock::now() < deadline;
+    };
+    vector<int> ids = c.getIds();
+    unordered_map<int, int> localIndex;
+    for (size_t i = 0; i < ids.size(); ++i) localIndex[ids[i]] = i;
+
+    for (int round = 0; best.width > lowerBound.get() && timeLeft(); ++round) {
+        // Contracted pairs and the offset of every line of the sequence
+        string sequence = best.stringSequence.str();
+        vector<pair<int, int>> steps;
+        vector<size_t> lineStart;
+        for (size_t position = 0; position < sequence.size(); position = sequence.find('\n', position) + 1) {
+            int v1, v2;
+            istringstream(sequence.substr(position, sequence.find('\n', position) - position)) >> v1 >> v2;
+            lineStart.push_back(position);
+            steps.push_back({localIndex[v1 - 1], localIndex[v2 - 1]});
+        }
+        lineStart.push_back(sequence.size());
+
+        Graph replay = initial;
+        int peakStep = 0;
+        while (peakStep < static_cast<int>(steps.size()) && replay.getWidth() < best.width) {
+            replay.mergeVertices(steps[peakStep].first, steps[peakStep].second);
+            peakStep++;
+        }
+        if (replay.getWidth() < best.width) break;
+        peakStep--;
+
+        vector<int> windowStarts;
+        for (int k = 0; k < REFINEMENT_WINDOWS && (windowStarts.empty() || windowStarts.back() > 0); ++k) {
+            windowStarts.push_back(max(0, peakStep - (4 << (2 * k))));
+        }
+        // Longer suffixes than the time left allows are not started, the average step of the first run overestimates
+        // the steps near the end
+        double budget = duration<double>(deadline - high_resolution_clock::now()).count();
+        while (!windowStarts.empty() && (steps.size() - windowStarts.back()) * secondsPerStep > budget) windowStarts.pop_back();
+        if (windowStarts.empty()) break;
+        // Snapshots before the first step of every window, the largest window starts first
+        vector<Graph> snapshots(windowStarts.size());
+        replay = initial;
+        int replayed = 0;
+        for (int w = windowStarts.size() - 1; w >= 0; --w) {
+            for (; replayed < windowStarts[w]; ++replayed) replay.mergeVertices(steps[replayed].first, steps[replayed].second);
+            snapshots[w] = replay;
+        }
+
+        // Ties go to the earliest attempt, so the result does not depend on the order the attempts finish in
+        std::mutex resultMutex;
+        int bestAttempt = -1;
+        int bestWidth = best.width;
+        Graph bestGraph;
+        string bestSuffix;
+        getScoringPool().parallelFor(windowStarts.size() * REFINEMENT_SEEDS, [&](int attemptIndex) {
+            if (!timeLeft()) return;
+            Graph attempt = snapshots[attemptIndex / REFINEMENT_SEEDS];
+            attempt.setLogSteps(false);
+            attempt.setSeed(12345 + 1000 * (round + 1) + attemptIndex);
+            ostringstream suffix = attemptIndex % REFINEMENT_SEEDS == 0 ? attempt.findDegreeContraction(best.width, nullptr, deadline)
+                                                                        : attempt.findRedDegreeContractionRandomWalk(best.width, nullptr, deadline);
+            if (attempt.getVertices().size() != 1) return;
+
+            std::lock_guard<std::mutex> lock(resultMutex);
+            if (attempt.getWidth() < bestWidth || (attempt.getWidth() == bestWidth && bestAttempt != -1 && attemptIndex < bestAttempt)) {
+                bestAttempt = attemptIndex;
+                bestWidth = attempt.getWidth();
+                bestGraph = std::move(attempt);
+                bestSuffix = suffix.str();
+            }
+        });
+        if (bestAttempt == -1) break;
+
+        int windowStart = windowStarts[bestAttempt / REFINEMENT_SEEDS];
+        cout << "c Refinement improved width from " << best.width << " to " << bestWidth << " by recomputing "
+             << steps.size() - windowStart << " steps after step " << windowStart << endl;
+        best.stringSequence.str(sequence.substr(0, lineStart[windowStart]) + bestSuffix);
+        best.width = bestWidth;
+        upperBound = best.width;
+        c = std::move(bestGraph);
+    }
+}
+
+// Runs the heuristic on c, with restarts or refinement a lower bound is computed in parallel. The reduction rules first replace c by its kernel,
+// then the cost model chooses the engine that is expected to give the lowest width within the time until deadline.
+// features are the ones the caller computed for the time split, they are only recomputed if c has changed since.
+// The choice is stored in engine before the run starts. With alternativeEngines the other modelled engine runs
+// afterwards if its predicted runtime fits before deadline. With restarts enabled the random walk
+// (or its bipartite variant) is rerun with new seeds until its width matches the lower bound or the deadline is reached.
+// The first run saves checkpoints, a resumed run continues from its saved state with the engine it was started with.
+// Afterwards c holds the contracted graph of the returned solution.
+ComponentSolution solveComponent(Graph& c, const high_resolution_clock::time_point& deadline, Checkpoint& checkpoint,
+                                 Engine& engine, const ComponentFeatures* features = nullptr, const ResumedRun* resumed = nullptr) {
+    // Only restarts and refinement stop at the bound, without them it would just take CPU time from the heuristic
+    bool runLowerBound = lowerBounds && (restarts || refinement);
+    std::atomic<int> upperBound(INT_MAX);
+    std::atomic<bool> stopLowerBound(false);
+    LowerBound lowerBound(runLowerBound ? c.getBlackAdjacency() : vector<vector<int>>());
+    if (runLowerBound) getLowerBoundThread().run([&]() { lowerBound.compute(upperBound, stopLowerBound); });
+
+    // The heuristics only see the kernel, the forced contractions go in front of their sequence
+    ostringstream reductionSequence;
+    int reductionWidth = 0;
+    Graph unreduced;
+    if (reductionRules && !c.hasRedEdges()) {
+        vector<vector<int>> adjacency = c.getRemainingAdjacency();
+        Reductions reductions(adjacency);
+        reductions.run(pathReduction);
+        if (!reductions.getContractions().empty()) {
+            if (reductions.getContractions().size() < REDUCTION_MIN_SHARE * c.getVertices().size()) unreduced = c;
+            vector<int> remaining = c.getVertices();
+            for (const pair<int, int>& step : reductions.getContractions()) {
+                reductionSequence << c.getVertexId(remaining[step.first]) + 1 << " " << c.getVertexId(remaining[step.second]) + 1 << "\n";
+            }
+            c = c.kernelGraph(reductions);
+            reductionWidth = reductions.getWidth();
+            cout << "c Reductions: " << reductions.getTreeContractions() << " tree, " << reductions.getPendantContractions() << " pendant, "
+                 << reductions.getPathContractions() << " path contractions, kernel of " << c.getVertices().size() << " vertices" << endl;
+        }
+    }
+
+    vector<int> partition1;
+    vector<int> partition2;
+    bool isBipartite = c.getVertices().size() > 2 && c.isBipartiteBoost(partition1, partition2);
+    if (isBipartite) cout << "c Bipartite: " << partition1.size() << " + " << partition2.size() << endl;
+
+    // The degree deviation rule, the cost model only overrides it on a clear predicted gain. Bipartite components go to
+    // the bipartite engine with bipartiteContraction, the model does not cover it.
+    bool trivial = c.getVertices().size() < 2;
+    Engine ruleEngine = ENGINE_COUNT;
+    if (!trivial) {
+        if (bipartiteContraction && isBipartite) ruleEngine = BIPARTITE_ENGINE;
+        else ruleEngine = c.getDegreeDeviation() <= 25.0 ? RANDOM_WALK_ENGINE : DEGREE_ENGINE;
+    }
+    bool modelled = (engineSelection || forcedEngine != ENGINE_COUNT) && c.getVertices().size() >= static_cast<size_t>(SELECTION_MIN_VERTICES);
+    ComponentFeatures kernelFeatures;
+    if (modelled) {
+        bool unchanged = features != nullptr && static_cast<size_t>(features->vertices) == c.getVertices().size();
+        kernelFeatures = unchanged ? *features : c.getFeatures(isBipartite);
+        kernelFeatures.bipartite = isBipartite;
+        cout << "c Features: n " << kernelFeatures.vertices << ", m " << kernelFeatures.edges << ", mean degree " << kernelFeatures.meanDegree
+             << ", max degree " << kernelFeatures.maxDegree << ", deviation " << kernelFeatures.degreeDeviation << ", bipartite "
+             << kernelFeatures.bipartite << ", twins " << kernelFeatures.twinRatio << ", clustering " << kernelFeatures.clustering << endl;
+    }
+    double budget = duration<double>(deadline - high_resolution_clock::now()).count();
+    if (resumed != nullptr && resumed->engine != ENGINE_COUNT) {
+        engine = resumed->engine;
+    }
+    else if (trivial) {
+        engine = DEGREE_ENGINE;
+    }
+    else if (forcedEngine != ENGINE_COUNT) {
+        engine = forcedEngine == BIPARTITE_ENGINE && !isBipartite ? RANDOM_WALK_ENGINE : forcedEngine;
+    }
+    else if (modelled && isModelled(ruleEngine)) {
+        engine = costModel.select(kernelFeatures, budget, ruleEngine, SELECTION_MARGIN);
+    }
+    else {
+        cout << "c Deviation: " << c.getDegreeDeviation() << endl;
+        engine = ruleEngine;
+    }
+    if (modelled && isModelled(engine)) {
+        cout << "c Engine: " << engineName(engine) << ", predicted " << costModel.predictSeconds(engine, kernelFeatures) << " s and width "
+             << costModel.predictWidth(engine, kernelFeatures) << ", budget " << budget << " s" << endl;
+    }
+    bool bipartite = engine == BIPARTITE_ENGINE;
+    bool randomized = engine != DEGREE_ENGINE;
+    bool alternatives = alternativeEngines && engineSelection && forcedEngine == ENGINE_COUNT && modelled && isModelled(engine);
+    Graph initial;
+    if ((restarts && randomized) || refinement || alternatives) initial = c;
+
+    // Scoring runs on the pool threads as well, their misses are counted with the calling thread's. The counters are
+    // only opened with telemetry, so other runs do not pay for the perf_event_open calls of every component.
+    std::optional<CacheCounters> counters;
+    if (cacheTelemetry) {
+        counters.emplace(getScoringPool().getWorkerIds());
+        counters->start();
+    }
+
+    ComponentSolution best;
+    int lastSide = 1;
+    if (resumed != nullptr) {
+        Graph fresh = c;
+        Checkpoint::Reader reader(resumed->state);
+        if (c.loadState(reader)) {
+            int extra = reader.get<int>();
+            if (bipartite) lastSide = extra;
+            best.stringSequence << resumed->sequence;
+            cout << "c Resumed heuristic with " << c.getVertices().size() << " vertices left, tww: " << c.getWidth() << endl;
+        }
+        else {
+            c = std::move(fresh);
+            cout << "c Could not restore the heuristic state, restarting the component" << endl;
+        }
+    }
+
+    checkpoint.startSequence();
+    int engineSteps = c.getVertices().size() - 1;
+    auto engineStart = high_resolution_clock::now();
+    if (bipartite) best.stringSequence << c.findBipartiteContraction(partition1, partition2, INT_MAX, &checkpoint, lastSide).str();
+    else if (engine == RANDOM_WALK_ENGINE) best.stringSequence << c.findRedDegreeContractionRandomWalk(INT_MAX, &checkpoint).str();
+    else best.stringSequence << c.findDegreeContraction(INT_MAX, &checkpoint).str();
+    best.width = c.getWidth();
+    upperBound = best.width;
+    double engineSeconds = duration<double>(high_resolution_clock::now() - engineStart).count();
+    if (!trivial) cout << "c Engine " << engineName(engine) << ": width " << best.width << " in " << engineSeconds << " s" << endl;
+
+    if (counters) {
+        counters->stop();
+        if (counters->available()) cout << "c Cache misses: " << counters->getCacheMisses() << ", dTLB misses: " << counters->getTlbMisses() << endl;
+        else cout << "c Cache misses: unavailable (perf_event_open failed)" << endl;
+    }
+
+    // The width predictions are coarse (a mean error of about 10 in the calibration), so the other engine runs as well
+    // when its predicted runtime fits. It stops as soon as it reaches the width found so far.
+    for (int e = 0; alternatives && e < ENGINE_COUNT && best.width > 0; ++e) {
+        Engine other = static_cast<Engine>(e);
+        if (other == engine || !isModelled(other)) continue;
+        double timeLeft = duration<double>(deadline - high_resolution_clock::now()).count();
+        if (costModel.predictSeconds(other, kernelFeatures) > timeLeft) continue;
+        Graph attempt = initial;
+        attempt.setLogSteps(false);
+        ostringstream sequence = other == RANDOM_WALK_ENGINE ? attempt.findRedDegreeContractionRandomWalk(best.width, nullptr, deadline)
+                                                             : attempt.findDegreeContraction(best.width, nullptr, deadline);
+        if (attempt.getVertices().size() == 1 && attempt.getWidth() < best.width) {
+            best.stringSequence.str(sequence.str());
+            best.width = attempt.getWidth();
+            upperBound = best.width;
+            c = std::move(attempt);
+            cout << "c Engine " << engineName(other) << " improved width to " << best.width << endl;
+        }
+    }
+
+    // Removing a few pendant twins saves little work but sends the heuristic on another path, which may end higher.
+    // The same engine then runs on the whole component as well, the better sequence is kept.
+    bool checkUnreduced = !unreduced.getVertices().empty() && !bipartite && best.width > reductionWidth;
+    if (checkUnreduced && modelled) {
+        double timeLeft = duration<double>(deadline - high_resolution_clock::now()).count();
+        checkUnreduced = costModel.predictSeconds(engine, kernelFeatures) <= timeLeft;
+    }
+    if (checkUnreduced && high_resolution_clock::now() < deadline) {
+        Graph attempt = unreduced;
+        attempt.setLogSteps(false);
+        int reducedWidth = max(best.width, reductionWidth);
+        ostringstream sequence = engine == RANDOM_WALK_ENGINE ? attempt.findRedDegreeContractionRandomWalk(reducedWidth, nullptr, deadline)
+                                                              : attempt.findDegreeContraction(reducedWidth, nullptr, deadline);
+        if (attempt.getVertices().size() == 1 && attempt.getWidth() < reducedWidth) {
+            best.stringSequence.str(sequence.str());
+            best.width = attempt.getWidth();
+            upperBound = best.width;
+            c = std::move(attempt);
+            reductionSequence.str("");
+            reductionWidth = 0;
+            initial = std::move(unreduced);
+            cout << "c Engine " << engineName(engine) << " on the unreduced component improved width to " << best.width << endl;
+        }
+    }
+
+    unsigned int seed = 12345;
+    while (restarts && randomized && best.width > lowerBound.get()
+           && high_resolution_clock::now() < deadline) {
+        Graph attempt = initial;
+        attempt.setSeed(++seed);
+        ostringstream sequence = bipartite ? attempt.findBipartiteContraction(partition1, partition2, best.width, nullptr, 1, deadline)
+                                           : attempt.findRedDegreeContractionRandomWalk(best.width, nullptr, deadline);
+        if (attempt.getVertices().size() == 1 && attempt.getWidth() < best.width) {
+            best.stringSequence.str(sequence.str());
+            best.width = attempt.getWidth();
+            upperBound = best.width;
+            c = attempt;
+            cout << "c Restart with seed " << seed << " improved width to " << best.width << endl;
+        }
+    }
+
+    if (refinement) refineSolution(c, initial, best, lowerBound, upperBound, deadline, engineSeconds / max(1, engineSteps));
+
+    if (!reductionSequence.str().empty()) {
+        best.stringSequence.str(reductionSequence.str() + best.stringSequence.str());
+        best.width = max(best.width, reductionWidth);
+    }
+
+    if (runLowerBound) {
+        stopLowerBound = true;
+        getLowerBoundThread().wait();
+        cout << "c Lower bound: " << lowerBound.get() << ", width: " << best.width << endl;
+    }
+    return best;
+}
+
+// Prints the peak RSS since the last call and resets it, so that every phase gets its own peak
+void reportPeakRss(const string& phase) {
+    if (!memoryReport) return;
+    cout << "c Peak RSS (" << phase << "): " << MemoryUsage::peakRssKb() / 1024 << " MB" << endl;
+    MemoryUsage::resetPeakRss();
+}
+
+// Options the cached component partition and twin classes depend on
+uint32_t graphCacheOptions() {
+    return vertexOrdering | connectedComponents << 8 | twinsElimination << 9;
+}
+
+// Options a checkpointed run depends on, a checkpoint of another configuration is not resumed. The reductions decide
+// which kernel a saved heuristic state belongs to, refinement rewrites the output of a component.
+uint32_t checkpointOptions() {
+    return graphCacheOptions() | bipartiteContraction << 10 | restarts << 11 | lowerBounds << 12 | scaleCandidates << 13
+           | reductionRules << 14 | pathReduction << 15 | refinement << 16 | alternativeEngines << 17;
+}
+
+// Progress of the whole run, stored with every checkpoint
+struct RunProgress {
+    int component = 0;           // first component that is not finished
+    int maxTww = 0;
+    vector<int> remainingVertices;
+    vector<uint64_t> output;     // journal ranges [begin, end) with the output of the finished components
+    uint64_t runStart = 0;       // journal offset of the sequence of the heuristic running on component
+    Engine engine = ENGINE_COUNT; // engine running on component
+
+    void addOutput(uint64_t begin, uint64_t end) {
+        if (!output.empty() && output.back() == begin) output.back() = end;
+        else output.insert(output.end(), {begin, end});
+    }
+
+    string save() const {
+        Checkpoint::Writer writer;
+        writer.put(component);
+        writer.put(maxTww);
+        writer.putList(remainingVertices);
+        writer.putList(output);
+        writer.put(runStart);
+        writer.put(engine);
+        return writer.str();
+    }
+
+    bool load(const string& data) {
+        Checkpoint::Reader reader(data);
+        component = reader.get<int>();
+        maxTww = reader.get<int>();
+        remainingVertices = reader.getVector<int>();
+        output = reader.getVector<uint64_t>();
+        runStart = reader.get<uint64_t>();
+        engine = reader.get<Engine>();
+        return reader.ok() && output.size() % 2 == 0 && engine >= 0 && engine <= ENGINE_COUNT;
+    }
+};
+
+void writeGraphCache(const string& path, const GraphCache::InputIdentity& input, vector<Graph>& components, const vector<TwinClasses>& twinClasses) {
+    int numVertices = 0;
+    for (Graph& c : components) numVertices += c.getIds().size();
+
+    vector<uint64_t> adjacencyOffsets(numVertices + 1, 0);
+    vector<uint64_t> componentOffsets = {0};
+    vector<int32_t> componentIds;
+    vector<int32_t> localIndex(numVertices);
+    for (Graph& c : components) {
+        vector<int> ids = c.getIds();
+        vector<vector<int>> adj = c.getBlackAdjacency();
+        for (size_t i = 0; i < ids.size(); ++i) {
+            adjacencyOffsets[ids[i] + 1] = adj[i].size();
+            localIndex[ids[i]] = i;
+            componentIds.push_back(ids[i]);
+        }
+        componentOffsets.push_back(componentIds.size());
+    }
+    for (int v = 0; v < numVertices; ++v) adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+
+    vector<int32_t> adjacency(adjacencyOffsets[numVertices]);
+    for (Graph& c : components) {
+        vector<int> ids = c.getIds();
+        vector<vector<int>> adj = c.getBlackAdjacency();
+        for (size_t i = 0; i < ids.size(); ++i) {
+            uint64_t position = adjacencyOffsets[ids[i]];
+            for (int u : adj[i]) adjacency[position++] = ids[u];
+        }
+    }
+
+    vector<int32_t> twinData;
+    for (size_t k = 0; k < twinClasses.size(); ++k) {
+        for (int kind = 0; kind < 2; ++kind) {
+            for (const vector<int>& members : kind == 0 ? twinClasses[k].trueTwins : twinClasses[k].falseTwins) {
+                twinData.push_back(k);
+                twinData.push_back(kind);
+                twinData.push_back(members.size());
+                twinData.insert(twinData.end(), members.begin(), members.end());
+            }
+        }
+    }
+
+    if (!GraphCache::write(path, input, graphCacheOptions(), adjacencyOffsets, adjacency, componentOffsets, componentIds, localIndex, twinData)) {
+        cout << "c Could not write graph cache " << path << endl;
+    }
+}
+
+Graph readCacheComponent(const GraphCache& cache, int k) {
+    const int32_t* begin = cache.componentIds + cache.componentOffsets[k];
+    vector<int> ids(begin, cache.componentIds + cache.componentOffsets[k + 1]);
+
+    Graph g;
+    g.addVertices(ids.size(), ids);
+    for (int i = 0; i < static_cast<int>(ids.size()); ++i) {
+        for (uint64_t p = cache.adjacencyOffsets[ids[i]]; p < cache.adjacencyOffsets[ids[i] + 1]; ++p) {
+            int u = cache.localIndex[cache.adjacency[p]];
+            if (i < u) g.addEdgeBegin(i, u);
+        }
+    }
+    g.updateBlackDegrees();
+    return g;
+}
+
+vector<Graph> readGraphCache(const GraphCache& cache, vector<TwinClasses>& twinClasses) {
+    vector<Graph> components(cache.numComponents);
+    for (uint64_t k = 0; k < cache.numComponents; ++k) components[k] = readCacheComponent(cache, k);
+
+    twinClasses.assign(cache.numComponents, TwinClasses());
+    for (uint64_t p = 0; p < cache.numTwinEntries;) {
+        int k = cache.twinData[p], kind = cache.twinData[p + 1], size = cache.twinData[p + 2];
+        vector<int> members(cache.twinData + p + 3, cache.twinData + p + 3 + size);
+        (kind == 0 ? twinClasses[k].trueTwins : twinClasses[k].falseTwins).push_back(members);
+        p += 3 + size;
+    }
+    return components;
+}
+
+// Worker process: solves the components it claims from the board until none is left. The component is read from
+// the shared cache mapping, its time share follows the predicted runtime of the components not claimed yet.
+// Returns false if a result did not fit into its slot, the component is then left to the retry of the coordinator.
+bool runWorker(int worker, ResultBoard& board, const GraphCache& cache, const vector<TwinClasses>& twinClasses,
+               const vector<ComponentFeatures>& features, const high_resolution_clock::time_point& programStart) {
+    Checkpoint checkpoint;
+    double remainingPrediction = 0;
+    for (int k = board.claim(worker, remainingPrediction); k != -1; k = board.claim(worker, remainingPrediction)) {
+        Graph c = readCacheComponent(cache, k);
+        ostringstream twinContraction;
+        if (twinsElimination) twinContraction = c.contractTwins(twinClasses[k]);
+
+        auto now = high_resolution_clock::now();
+        auto deadline = programStart + seconds(TIME_LIMIT);
+        if (remainingPrediction > 0) {
+            double share = min(1.0, workers * board.slot(k).predictedSeconds / remainingPrediction);
+            share *= max(0.0, duration<double>(deadline - now).count());
+            deadline = now + duration_cast<high_resolution_clock::duration>(duration<double>(share));
+        }
+
+        Engine engine = ENGINE_COUNT;
+        ComponentSolution solution = solveComponent(c, deadline, checkpoint, engine, &features[k]);
+        int remainingVertex = c.getVertexId(*c.getVertices().begin()) + 1;
+        if (!board.publish(k, twinContraction.str() + solution.stringSequence.str(), solution.width, remainingVertex)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Forks one worker per id, waits for all of them and reports the ones that did not exit cleanly
+void runWorkers(const vector<int>& ids, ResultBoard& board, const GraphCache& cache, const vector<TwinClasses>& twinClasses,
+                const vector<ComponentFeatures>& features, const high_resolution_clock::time_point& programStart) {
+    cout.flush();
+    map<pid_t, int> running;
+    for (int id : ids) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            // Only the coordinator writes the output
+            int devNull = open("/dev/null", O_WRONLY);
+            if (devNull != -1) dup2(devNull, STDOUT_FILENO);
+            bool published = runWorker(id, board, cache, twinClasses, features, programStart);
+            cout.flush();
+            _exit(published ? 0 : 1);
+        }
+        if (pid == -1) cout << "c Could not start worker " << id << endl;
+        else running[pid] = id;
+    }
+
+    int status;
+    for (pid_t pid; !running.empty() && (pid = wait(&status)) != -1;) {
+        if (running.count(pid) == 0) continue;
+        int id = running[pid];
+        running.erase(pid);
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 0) continue;
+        cout << "c Worker " << id << (WIFSIGNALED(status) ? " killed by signal " + to_string(WTERMSIG(status)) : " failed");
+        for (int k = 0; k < board.size(); ++k) {
+            if (!board.done(k) && board.slot(k).worker.load() == id) cout << ", component " << k << " is unsolved";
+        }
+        cout << endl;
+    }
+}
+
+// Solves all components with worker processes and collects the results into progress as the sequential loop does.
+// The workers share the graph through a read-only mapping of the graph cache, a temporary cache is written if the run
+// has none. Components are claimed in order of decreasing predicted runtime. Components whose worker died are handed
+// out once more, after that they are contracted into a single vertex.
+void solveWithWorkers(vector<Graph>& components, const vector<TwinClasses>& twinClasses, const string& cachePath,
+                      const GraphCache::InputIdentity& inputIdentity, const high_resolution_clock::time_point& programStart,
+                      RunProgress& progress) {
+    auto start = high_resolution_clock::now();
+    int numComponents = components.size();
+    int numVertices = 0;
+    for (Graph& c : components) numVertices += c.getIds().size();
+    int digits = to_string(numVertices).size();
+
+    // A sequence has at most n - 1 contractions of two ids and a separator each
+    vector<uint64_t> capacities(numComponents);
+    vector<ComponentFeatures> features(numComponents);
+    vector<double> predictedSeconds(numComponents, 0);
+    vector<int> order(numComponents);
+    for (int k = 0; k < numComponents; ++k) {
+        int n = components[k].getIds().size();
+        capacities[k] = static_cast<uint64_t>(max(n - 1, 0)) * (2 * digits + 2);
+        if (engineSelection && n >= SELECTION_MIN_VERTICES) {
+            features[k] = components[k].getFeatures(false);
+            predictedSeconds[k] = costModel.predictSeconds(costModel.select(features[k], 0), features[k]);
+        }
+        order[k] = k;
+    }
+    stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        if (predictedSeconds[a] != predictedSeconds[b]) return predictedSeconds[a] > predictedSeconds[b];
+        return capacities[a] > capacities[b];
+    });
+
+    GraphCache cache;
+    bool cached = !cachePath.empty() && cache.open(cachePath, inputIdentity, graphCacheOptions());
+    if (!cached) {
+        char tmpPath[] = "/tmp/twin-width-XXXXXX";
+        int fd = mkstemp(tmpPath);
+        if (fd != -1) {
+            ::close(fd);
+            writeGraphCache(tmpPath, inputIdentity, components, twinClasses);
+            cached = cache.open(tmpPath, inputIdentity, graphCacheOptions());
+            unlink(tmpPath);
+        }
+    }
+    ResultBoard board;
+    if (!cached || !board.create(capacities, predictedSeconds)) {
+        cout << "c Could not set up the worker processes, solving sequentially" << endl;
+        return;
+    }
+    for (Graph& c : components) c = Graph();
+
+    // The scoring threads of one machine are split among the workers
+    if (scoringThreads == 0) scoringThreads = max(1u, std::thread::hardware_concurrency() / workers);
+
+    vector<int> ids(min(workers, numComponents));
+    for (size_t i = 0; i < ids.size(); ++i) ids[i] = i;
+    board.setOrder(order);
+    runWorkers(ids, board, cache, twinClasses, features, programStart);
+
+    vector<int> unsolved;
+    for (int k : order) {
+        if (!board.done(k)) unsolved.push_back(k);
+    }
+    if (!unsolved.empty()) {
+        cout << "c Retrying " << unsolved.size() << " components" << endl;
+        vector<int> retryIds(min<int>(workers, unsolved.size()));
+        for (size_t i = 0; i < retryIds.size(); ++i) retryIds[i] = workers + i;
+        board.setOrder(unsolved);
+        runWorkers(retryIds, board, cache, twinClasses, features, programStart);
+    }
+
+    int solved = 0;
+    for (int k = 0; k < numComponents; ++k) {
+        if (board.done(k)) {
+            solved++;
+            cout << board.sequence(k);
+            progress.maxTww = max(progress.maxTww, board.slot(k).width);
+            progress.remainingVertices.push_back(board.slot(k).remainingVertex);
+            continue;
+        }
+        // Contracting everything into one vertex gives it a red edge to every other vertex at most
+        const int32_t* ids = cache.componentIds + cache.componentOffsets[k];
+        int n = cache.componentOffsets[k + 1] - cache.componentOffsets[k];
+        cout << "c Component " << k << " is unsolved, contracting it into one vertex" << endl;
+        for (int i = 1; i < n; ++i) cout << ids[0] + 1 << " " << ids[i] + 1 << endl;
+        progress.maxTww = max(progress.maxTww, n - 2);
+        progress.remainingVertices.push_back(ids[0] + 1);
+    }
+    progress.component = numComponents;
+
+    auto duration = duration_cast<milliseconds>(high_resolution_clock::now() - start);
+    cout << "c Workers: " << workers << " processes solved " << solved << " of " << numComponents << " components in " << duration.count() << " ms" << endl;
+}
+
+Graph readGraph(istream& input) {
     Graph g;
-    BoostGraph boostGraph;
     string line;
     int numVertices, numEdges;
     set<pair<int, int>> readEdges;
     double density;
-    int maxTww = 0;
     bool constructComplement = false;
 
-    auto start = high_resolution_clock::now(); 
-
-    while (getline(cin, line)) {
+    while (getline(input, line)) {
         if (line[0] == 'c') {
             continue;
         }
@@ -757,7 +1835,6 @@ int main() {
             int u = stoi(tokens[0]);
             int v = stoi(tokens[1]);
             g.addEdgeBegin(u - 1, v - 1);
-            boostGraph.addEdge(u - 1, v - 1);
         }
     }
 
@@ -766,54 +1843,176 @@ int main() {
             for (int j = i + 1; j < numVertices; j++) {
                 if (readEdges.find({i, j}) == readEdges.end()) {
                     g.addEdgeBegin(i, j);
-                    boostGraph.addEdge(i, j);
                 }
             }
         }
     }
     g.updateBlackDegrees();
     g.setIds(g.getVertices());
+    return g;
+}
 
-    auto stop = high_resolution_clock::now();
-    auto duration = duration_cast<seconds>(stop - start);
-    std::cout << "c Time taken too initialize the graph: " << duration.count() << " seconds" << std::endl;
+int main(int argc, char* argv[]) {
+    string cachePath;
+    string checkpointPath;
+    bool resume = false;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--cache" && i + 1 < argc) cachePath = argv[++i];
+        else if (arg == "--checkpoint" && i + 1 < argc) checkpointPath = argv[++i];
+        else if (arg == "--resume") resume = true;
+        else if (arg == "--workers" && i + 1 < argc) workers = max(1, atoi(argv[++i]));
+        else if (arg == "--engine" && i + 1 < argc) {
+            forcedEngine = engineFromName(argv[++i]);
+            if (forcedEngine == ENGINE_COUNT) cout << "c Unknown engine " << argv[i] << ", the cost model chooses" << endl;
+        }
+        else if (arg == "--no-selection") engineSelection = false;
+        else if (arg == "--cost-model" && i + 1 < argc) {
+            if (!costModel.load(argv[++i])) cout << "c Could not read cost model " << argv[i] << ", using the built-in one" << endl;
+        }
+    }
+
+    RunProgress progress;
+    int& maxTww = progress.maxTww;
+    vector<int>& remainingVertices = progress.remainingVertices;
+
+    auto start = high_resolution_clock::now(); 
+    auto programStart = start;
+
+    // A regular input file is identified by size and modification time, piped input has to be read and hashed
+    GraphCache::InputIdentity inputIdentity;
+    istream* input = &cin;
+    istringstream bufferedInput;
+    if (!cachePath.empty() || !checkpointPath.empty()) {
+        struct stat inputStat;
+        if (fstat(STDIN_FILENO, &inputStat) == 0 && S_ISREG(inputStat.st_mode)) {
+            inputIdentity.size = inputStat.st_size;
+            inputIdentity.modified = inputStat.st_mtim.tv_sec * 1000000000LL + inputStat.st_mtim.tv_nsec;
+        }
+        else {
+            string text((istreambuf_iterator<char>(cin)), istreambuf_iterator<char>());
+            inputIdentity.size = text.size();
+            inputIdentity.hash = GraphCache::hash(text.data(), text.size());
+            bufferedInput.str(std::move(text));
+            input = &bufferedInput;
+        }
+    }
 
-    start = high_resolution_clock::now(); 
-    
     vector<Graph> components;
-    if (connectedComponents) {
-        components = g.findConnectedComponentsBoost();
+    vector<TwinClasses> twinClasses;
+    GraphCache cache;
+    if (!cachePath.empty() && cache.open(cachePath, inputIdentity, graphCacheOptions())) {
+        components = readGraphCache(cache, twinClasses);
+        cache.close();
+
+        auto stop = high_resolution_clock::now();
+        auto duration = duration_cast<milliseconds>(stop - start);
+        cout << "c Loaded graph cache " << cachePath << " in " << duration.count() << " ms" << endl;
     }
     else {
-        components.push_back(g);
-    }
-    
-    stop = high_resolution_clock::now();
-    duration = duration_cast<seconds>(stop - start);
-    cout << "c Time taken for connected components: " << duration.count() << " seconds" << std::endl;
+        Graph g = readGraph(*input);
 
-    std::vector<int> remainingVertices;
-    for (Graph& c : components) {
-        ostringstream componentContraction;
-        vector<int> partition1;
-        vector<int> partition2;
+        auto stop = high_resolution_clock::now();
+        auto duration = duration_cast<seconds>(stop - start);
+        std::cout << "c Time taken too initialize the graph: " << duration.count() << " seconds" << std::endl;
+
+        start = high_resolution_clock::now(); 
+        
+        if (connectedComponents) {
+            components = g.findConnectedComponentsBoost();
+        }
+        else {
+            components.push_back(std::move(g));
+        }
+        
+        stop = high_resolution_clock::now();
+        duration = duration_cast<seconds>(stop - start);
+        cout << "c Time taken for connected components: " << duration.count() << " seconds" << std::endl;
 
         if (twinsElimination) {
             auto twin_start = high_resolution_clock::now();
-            ostringstream twins = c.findTwins(false);
-            cout << twins.str();
+            for (Graph& c : components) twinClasses.push_back(c.findTwinClasses());
             auto twin_stop = high_resolution_clock::now();
             auto twin_duration = duration_cast<seconds>(twin_stop - twin_start);
             cout << "c Time taken for twins detection: " << twin_duration.count() << " seconds" << std::endl;
         }
 
-        float degreeDeviation = c.getDegreeDeviation();
-        cout << "c Deviation: " << degreeDeviation << endl;
+        if (!cachePath.empty()) writeGraphCache(cachePath, inputIdentity, components, twinClasses);
+    }
+    reportPeakRss("reading and splitting");
+
+    // Worker processes solve all components, the loop below then has nothing left to do
+    if (workers > 1) {
+        if (!checkpointPath.empty()) {
+            cout << "c Checkpoints are not supported with --workers, ignoring --checkpoint" << endl;
+            checkpointPath.clear();
+        }
+        solveWithWorkers(components, twinClasses, cachePath, inputIdentity, programStart, progress);
+    }
+
+    // The output of the finished components is taken from the journal, the interrupted heuristic run continues
+    Checkpoint checkpoint;
+    ResumedRun resumedRun;
+    if (!checkpointPath.empty()) {
+        string savedProgress;
+        if (checkpoint.open(checkpointPath, inputIdentity, checkpointOptions(), checkpointInterval, resume, savedProgress, resumedRun.state)
+            && progress.load(savedProgress) && progress.component <= static_cast<int>(components.size())) {
+            for (size_t i = 0; i < progress.output.size(); i += 2) cout << checkpoint.readJournal(progress.output[i], progress.output[i + 1]);
+            if (!resumedRun.state.empty()) resumedRun.sequence = checkpoint.readJournal(progress.runStart, checkpoint.getJournalSize());
+            resumedRun.engine = progress.engine;
+            cout << "c Resumed from checkpoint " << checkpointPath << " at component " << progress.component << " of " << components.size() << endl;
+        }
+        else if (checkpoint.enabled()) {
+            if (resume) cout << "c No checkpoint for this input in " << checkpointPath << ", starting from scratch" << endl;
+            progress = RunProgress();
+            resumedRun.state.clear();
+        }
+        else cout << "c Could not open checkpoint journal " << checkpointPath << ".seq" << endl;
+        checkpoint.setProgress([&progress]() { return progress.save(); });
+    }
+
+    start = high_resolution_clock::now(); 
+
+    // Every component gets a share of the remaining time proportional to the predicted runtime of its fastest engine,
+    // time left over by a component goes to the following ones. The features are passed on to solveComponent.
+    vector<ComponentFeatures> features(components.size());
+    vector<double> predictedSeconds(components.size(), 0);
+    double remainingPrediction = 0;
+    if (engineSelection) {
+        for (size_t i = progress.component; i < components.size(); ++i) {
+            if (components[i].getVertices().size() < static_cast<size_t>(SELECTION_MIN_VERTICES)) continue;
+            features[i] = components[i].getFeatures(false);
+            predictedSeconds[i] = costModel.predictSeconds(costModel.select(features[i], 0), features[i]);
+            remainingPrediction += predictedSeconds[i];
+        }
+    }
 
-        if (degreeDeviation <= 25.0) cout << c.findRedDegreeContractionRandomWalk().str();
-        else cout << c.findDegreeContraction().str();
+    int resumedComponent = resumedRun.state.empty() ? -1 : progress.component;
+    for (int i = progress.component; i < static_cast<int>(components.size()); ++i) {
+        Graph& c = components[i];
+        ostringstream componentContraction;
+        bool resuming = i == resumedComponent;
 
-        maxTww = max(maxTww, c.getWidth());
+        ostringstream twinContraction;
+        if (twinsElimination) {
+            twinContraction = c.contractTwins(twinClasses[i]);
+            cout << twinContraction.str();
+        }
+
+        auto now = high_resolution_clock::now();
+        auto deadline = programStart + seconds(TIME_LIMIT);
+        if (remainingPrediction > 0) {
+            double share = max(0.0, duration<double>(deadline - now).count()) * predictedSeconds[i] / remainingPrediction;
+            deadline = now + duration_cast<high_resolution_clock::duration>(duration<double>(share));
+            remainingPrediction -= predictedSeconds[i];
+        }
+
+        progress.component = i;
+        if (!resuming) progress.runStart = checkpoint.getJournalSize();
+        ComponentSolution solution = solveComponent(c, deadline, checkpoint, progress.engine, &features[i], resuming ? &resumedRun : nullptr);
+        cout << solution.stringSequence.str();
+
+        maxTww = max(maxTww, solution.width);
 
         if (c.getVertices().size() == 1){
             int remainingVertex = c.getVertexId(*c.getVertices().begin()) + 1;
@@ -827,6 +2026,24 @@ int main() {
             lastPair >> remainingVertex;
             remainingVertices.push_back(remainingVertex);
         }
+
+        // The output is journaled as a whole, the sequence journaled during the run may have been replaced by a restart
+        if (checkpoint.enabled()) {
+            uint64_t outputStart = checkpoint.getJournalSize();
+            if (!checkpoint.append(twinContraction.str() + solution.stringSequence.str())) cout << "c Could not write checkpoint journal" << endl;
+            progress.addOutput(outputStart, checkpoint.getJournalSize());
+            progress.component = i + 1;
+            if (checkpoint.due()) checkpoint.save();
+        }
+
+        c = Graph();
+    }
+    reportPeakRss("solving");
+
+    if (checkpoint.enabled()) {
+        progress.component = components.size();
+        checkpoint.save();
+        cout << "c Checkpoints: " << checkpoint.getSaves() << " in " << static_cast<int>(checkpoint.getTotalCost() * 1000) << " ms" << endl;
     }
 
     int primaryVertex = remainingVertices[0];